@@ -39,10 +39,10 @@ Composition::getChildren ()
 Object *
 Composition::getChildById (const string &id)
 {
-  for (auto child : _children)
-    if (child->getId () == id)
-      return child;
-  return nullptr;
+  auto it = _childrenById.find (id);
+  if (it == _childrenById.end ())
+    return nullptr;
+  return it->second;
 }
 
 Object *
@@ -51,21 +51,40 @@ Composition::getChildByIdOrAlias (const string &id)
   Object *child;
   if ((child = this->getChildById (id)) != nullptr)
     return child;
-  for (auto child : _children)
-    if (child->hasAlias (id))
-      return child;
-  return nullptr;
+  auto it = _childrenByAlias.find (id);
+  if (it == _childrenByAlias.end ())
+    return nullptr;
+  return it->second;
 }
 
 void
 Composition::addChild (Object *child)
 {
   g_assert_nonnull (child);
-  if (tryinsert (child, _children, insert))
+  if (_children.insert (child).second)
     {
+      _childrenById.insert (std::make_pair (child->getId (), child));
+      for (auto &alias : *child->getAliases ())
+        this->addChildAlias (child, alias.first);
       child->initParent (this);
       g_assert (_doc->addObject (child));
     }
 }
 
+/**
+ * @brief Indexes alias of child.
+ *
+ * This function is called by Object::addAlias() when \p child gets a new
+ * alias.  If another child already has the alias, the index is unchanged.
+ *
+ * @param child The child object.
+ * @param alias The alias.
+ */
+void
+Composition::addChildAlias (Object *child, const string &alias)
+{
+  g_assert_nonnull (child);
+  _childrenByAlias.insert (std::make_pair (alias, child));
+}
+
 GINGA_NAMESPACE_END
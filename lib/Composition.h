@@ -32,9 +32,12 @@ public:
   Object *getChildById (const string &);
   Object *getChildByIdOrAlias (const string &);
   void addChild (Object *);
+  void addChildAlias (Object *, const string &);
 
 protected:
   set<Object *> _children;
+  unordered_map<string, Object *> _childrenById;    // children by id
+  unordered_map<string, Object *> _childrenByAlias; // children by alias
 };
 
 GINGA_NAMESPACE_END
@@ -167,6 +167,19 @@ Context::sendTick (Time total, Time diff, Time frame)
     }
 }
 
+Time
+Context::getTimeToNextDeadline ()
+{
+  if (!this->isOccurring ())
+    return GINGA_TIME_NONE;
+
+  // The next tick detects the end of the context.
+  if ((_parent == nullptr && _awakeChildren == 1) || _awakeChildren == 0)
+    return 0;
+
+  return Object::getTimeToNextDeadline ();
+}
+
 bool
 Context::beforeTransition (Event *evt, Event::Transition transition)
 {
@@ -295,23 +308,16 @@ Context::afterTransition (Event *evt, Event::Transition transition)
           {
             string name;
             string value;
-            string s;
             Time dur;
 
             name = evt->getId ();
-            evt->getParameter ("value", &value);
-            _doc->evalPropertyRef (value, &value);
-
-            dur = 0;
-            if (evt->getParameter ("duration", &s))
-              {
-                _doc->evalPropertyRef (s, &s);
-                dur = ginga::parse_time (s);
-              }
+            value = evt->getAttributionValue ();
+            dur = evt->getAttributionDuration ();
             this->setProperty (name, value, dur);
             this->addDelayedAction (evt, Event::STOP, value, dur);
-            TRACE ("start %s:='%s' (dur=%s)", evt->getFullId ().c_str (),
-                   value.c_str (), (s != "") ? s.c_str () : "0s");
+            TRACE ("start %s:='%s' (dur=%" GINGA_TIME_FORMAT ")",
+                   evt->getFullId ().c_str (), value.c_str (),
+                   GINGA_TIME_ARGS (dur));
             break;
           }
         case Event::STOP:
@@ -362,7 +368,42 @@ Context::addLink (list<Action> conds, list<Action> acts)
 {
   g_assert (conds.size () > 0);
   g_assert (acts.size () > 0);
-  _links.push_back (std::make_pair (conds, acts));
+  _links.push_back (std::make_pair (std::move (conds), std::move (acts)));
+
+  // Index the new link by its conditions.  List elements are never moved,
+  // so the pointers into the stored link remain valid.
+  auto &link = _links.back ();
+  for (const auto &cond : link.first)
+    {
+      g_assert_nonnull (cond.event);
+      _linksByCondition[std::make_pair (cond.event, cond.transition)]
+          .push_back (std::make_pair (&cond, &link.second));
+    }
+}
+
+// Compiles the conditions and actions of every link in context.  This
+// should be called once the whole document exists; see
+// Document::compileAction().
+void
+Context::compileLinks ()
+{
+  g_assert_nonnull (_doc);
+  for (auto &link : _links)
+    {
+      for (auto &cond : link.first)
+        _doc->compileAction (&cond);
+      for (auto &act : link.second)
+        _doc->compileAction (&act);
+    }
+}
+
+const vector<pair<const Action *, const list<Action> *> > *
+Context::getLinksByCondition (Event *evt, Event::Transition trans)
+{
+  auto it = _linksByCondition.find (std::make_pair (evt, trans));
+  if (it == _linksByCondition.end ())
+    return nullptr;
+  return &it->second;
 }
 
 void
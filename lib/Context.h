@@ -36,6 +36,7 @@ public:
   void setProperty (const string &, const string &, Time dur = 0) override;
   void sendKey (const string &, bool) override;
   void sendTick (Time, Time, Time) override;
+  Time getTimeToNextDeadline () override;
   bool beforeTransition (Event *, Event::Transition) override;
   bool afterTransition (Event *, Event::Transition) override;
 
@@ -45,6 +46,9 @@ public:
 
   const list<pair<list<Action>, list<Action> > > *getLinks ();
   void addLink (list<Action>, list<Action>);
+  void compileLinks ();
+  const vector<pair<const Action *, const list<Action> *> > *
+  getLinksByCondition (Event *, Event::Transition);
 
   void incAwakeChildren ();
   void decAwakeChildren ();
@@ -55,6 +59,10 @@ public:
 private:
   list<Event *> _ports;                            ///< List of ports.
   list<pair<list<Action>, list<Action> > > _links; ///< List of links.
+  map<pair<Event *, Event::Transition>,
+      vector<pair<const Action *, const list<Action> *> > >
+      _linksByCondition; ///< Link conditions indexed by event and
+                         ///< transition, paired with link actions.
   int _awakeChildren; ///< Counts awake children.
   bool _status;       ///< Whether links are active.
 };
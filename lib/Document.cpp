@@ -26,6 +26,233 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
+// Parses the whole of \p s as a finite number.  Unlike _xstrtod(), this
+// rejects strings with trailing garbage, such as "10px".
+static bool
+predicate_parse_number (const string &s, double *dp)
+{
+  const gchar *c_str;
+  gchar *endptr;
+  double d;
+
+  if (s.empty ())
+    return false;
+
+  c_str = s.c_str ();
+  d = g_ascii_strtod (c_str, &endptr);
+  if (endptr == c_str || *endptr != '\0' || !isfinite (d))
+    return false;
+
+  tryset (dp, d);
+  return true;
+}
+
+// Applies \p test to operands.  The operands are compared as numbers if
+// both are numeric, otherwise they are compared as strings.
+static bool
+predicate_apply_test (Predicate::Test test, const string &left,
+                      bool left_numeric, double left_number,
+                      const string &right, bool right_numeric,
+                      double right_number)
+{
+  int cmp;
+
+  if (left_numeric && right_numeric)
+    cmp = (left_number < right_number)
+              ? -1
+              : (left_number > right_number) ? 1 : 0;
+  else
+    cmp = left.compare (right);
+
+  switch (test)
+    {
+    case Predicate::EQ:
+      return cmp == 0;
+    case Predicate::NE:
+      return cmp != 0;
+    case Predicate::LT:
+      return cmp < 0;
+    case Predicate::LE:
+      return cmp <= 0;
+    case Predicate::GT:
+      return cmp > 0;
+    case Predicate::GE:
+      return cmp >= 0;
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+// ObjectList: public.
+
+/**
+ * @brief Creates a new object list.
+ * @param index Index of the object link used by list.
+ * @return New #ObjectList.
+ */
+ObjectList::ObjectList (int index)
+{
+  g_assert (index >= 0 && index < 2);
+  _index = index;
+  _head = nullptr;
+  _tail = nullptr;
+  _size = 0;
+  _stamp = 0;
+  _cursor = nullptr;
+  _walkStamp = 0;
+}
+
+/**
+ * @brief Gets the number of objects in list.
+ * @return Number of objects in list.
+ */
+size_t
+ObjectList::size ()
+{
+  return _size;
+}
+
+/**
+ * @brief Tests whether object is in list.
+ * @param obj The object to test.
+ * @return \c true if successful, or \c false otherwise.
+ */
+bool
+ObjectList::contains (Object *obj)
+{
+  g_assert_nonnull (obj);
+  return obj->_links[_index].linked;
+}
+
+/**
+ * @brief Inserts object at the end of list.
+ * @param obj The object to insert.
+ * @return \c true if successful, or \c false otherwise (already in list).
+ */
+bool
+ObjectList::insert (Object *obj)
+{
+  ObjectListLink *link;
+
+  g_assert_nonnull (obj);
+  link = &obj->_links[_index];
+  if (link->linked)
+    return false;
+
+  link->prev = _tail;
+  link->next = nullptr;
+  link->stamp = ++_stamp;
+  link->linked = true;
+
+  if (_tail != nullptr)
+    _tail->_links[_index].next = obj;
+  else
+    _head = obj;
+  _tail = obj;
+  _size++;
+
+  return true;
+}
+
+/**
+ * @brief Removes object from list.
+ * @param obj The object to remove.
+ * @return \c true if successful, or \c false otherwise (not in list).
+ */
+bool
+ObjectList::remove (Object *obj)
+{
+  ObjectListLink *link;
+
+  g_assert_nonnull (obj);
+  link = &obj->_links[_index];
+  if (!link->linked)
+    return false;
+
+  // Do not let the current walk visit a removed object.
+  if (_cursor == obj)
+    _cursor = link->next;
+
+  if (link->prev != nullptr)
+    link->prev->_links[_index].next = link->next;
+  else
+    _head = link->next;
+
+  if (link->next != nullptr)
+    link->next->_links[_index].prev = link->prev;
+  else
+    _tail = link->prev;
+
+  *link = { nullptr, nullptr, 0, false };
+  g_assert (_size > 0);
+  _size--;
+
+  return true;
+}
+
+/**
+ * @brief Starts a walk over the objects in list.
+ * @return The first object in list, or null if list is empty.
+ */
+Object *
+ObjectList::walkFirst ()
+{
+  _cursor = _head;
+  _walkStamp = _stamp;
+  return this->walkNext ();
+}
+
+/**
+ * @brief Gets the first object in list.
+ *
+ * Unlike ObjectList::walkFirst(), this function does not disturb the
+ * current walk.  The list must not be modified while it is traversed
+ * this way.
+ *
+ * @return The first object in list, or null if list is empty.
+ */
+Object *
+ObjectList::getFirst ()
+{
+  return _head;
+}
+
+/**
+ * @brief Gets the object that follows another one in list.
+ * @param obj An object in list.
+ * @return The next object in list, or null if \p obj is the last one.
+ */
+Object *
+ObjectList::getNext (Object *obj)
+{
+  g_assert_nonnull (obj);
+  g_assert (obj->_links[_index].linked);
+  return obj->_links[_index].next;
+}
+
+/**
+ * @brief Continues the current walk over the objects in list.
+ *
+ * Objects inserted after the walk has started are not visited.
+ *
+ * @return The next object in list, or null if the walk is over.
+ */
+Object *
+ObjectList::walkNext ()
+{
+  while (_cursor != nullptr)
+    {
+      Object *obj = _cursor;
+      ObjectListLink *link = &obj->_links[_index];
+      _cursor = link->next;
+      if (link->stamp <= _walkStamp)
+        return obj;
+    }
+  return nullptr;
+}
+
+// Document: public.
+
 /**
  * @brief Creates a new document.
  *
@@ -35,7 +262,7 @@ GINGA_NAMESPACE_BEGIN
  *
  * @return New #Document.
  */
-Document::Document ()
+Document::Document () : _awake (0), _occurring (1)
 {
   MediaSettings *obj;
 
@@ -93,10 +320,10 @@ Document::getObjectByIdOrAlias (const string &id)
   Object *obj;
   if ((obj = this->getObjectById (id)) != nullptr)
     return obj;
-  for (auto obj : _objects)
-    if (obj->hasAlias (id))
-      return obj;
-  return nullptr;
+  auto it = _objectsByAlias.find (id);
+  if (it == _objectsByAlias.end ())
+    return nullptr;
+  return it->second;
 }
 
 /**
@@ -126,6 +353,8 @@ Document::addObject (Object *obj)
   obj->initDocument (this);
   _objects.insert (obj);
   _objectsById[obj->getId ()] = obj;
+  for (auto &alias : *obj->getAliases ())
+    this->addObjectAlias (obj, alias.first);
 
   if (instanceof (Media *, obj))
     {
@@ -152,6 +381,22 @@ Document::addObject (Object *obj)
   return true;
 }
 
+/**
+ * @brief Indexes alias of document object.
+ *
+ * This function is called by Object::addAlias() when \p obj gets a new
+ * alias.  If another object already has the alias, the index is unchanged.
+ *
+ * @param obj The object.
+ * @param alias The alias.
+ */
+void
+Document::addObjectAlias (Object *obj, const string &alias)
+{
+  g_assert_nonnull (obj);
+  _objectsByAlias.insert (std::make_pair (alias, obj));
+}
+
 /**
  * @brief Gets document's root object.
  * @return The root object.
@@ -192,6 +437,90 @@ Document::getSwitches ()
   return &_switches;
 }
 
+/**
+ * @brief Gets the list of document objects that are not sleeping.
+ * @return The list of awake objects.
+ */
+ObjectList *
+Document::getAwakeObjects ()
+{
+  return &_awake;
+}
+
+/**
+ * @brief Gets the list of document objects that are occurring.
+ * @return The list of occurring objects.
+ */
+ObjectList *
+Document::getOccurringObjects ()
+{
+  return &_occurring;
+}
+
+/**
+ * @brief Updates the active lists of document with the state of object.
+ *
+ * This function is called by Event::transition() whenever the state of the
+ * lambda event of \p obj changes.
+ *
+ * @param obj The object whose state has changed.
+ */
+void
+Document::updateActiveObject (Object *obj)
+{
+  g_assert_nonnull (obj);
+  g_assert (obj->getDocument () == this);
+
+  if (obj->isSleeping ())
+    _awake.remove (obj);
+  else
+    _awake.insert (obj);
+
+  if (obj->isOccurring ())
+    _occurring.insert (obj);
+  else
+    _occurring.remove (obj);
+}
+
+/**
+ * @brief Removes object from the active lists of document.
+ * @param obj The object to remove.
+ */
+void
+Document::removeActiveObject (Object *obj)
+{
+  g_assert_nonnull (obj);
+  _awake.remove (obj);
+  _occurring.remove (obj);
+}
+
+/**
+ * @brief Gets the time remaining until the next tick is needed.
+ *
+ * Delayed actions are kept by each object in a heap ordered by object
+ * time.  Since the time of all occurring objects advances at the same
+ * rate, the next deadline in document is the smallest one reported by
+ * Object::getTimeToNextDeadline() among the occurring objects.
+ *
+ * @return The time until the next tick is needed, or #GINGA_TIME_NONE if
+ * nothing is scheduled.
+ */
+Time
+Document::getTimeToNextDeadline ()
+{
+  Time next = GINGA_TIME_NONE;
+
+  for (Object *obj = _occurring.getFirst (); obj != nullptr;
+       obj = _occurring.getNext (obj))
+    {
+      next = MIN (next, obj->getTimeToNextDeadline ());
+      if (next == 0)
+        break;
+    }
+
+  return next;
+}
+
 /**
  * @brief Evaluates action over document.
  */
@@ -210,88 +539,89 @@ Document::evalAction (Event *event, Event::Transition transition,
 
 /**
  * @brief Evaluates action over Context.
+ *
+ * Pushes onto \p stack the link actions triggered by \p act in \p ctx
+ * that should be evaluated immediately, and schedules the delayed ones.
+ * Link actions are stored in \p ctx, so \p stack only points to them.
  */
-list<Action>
-Document::evalActionInContext (Action act, Context *ctx)
+void
+Document::evalActionInContext (const Action &act, Context *ctx,
+                               vector<const Action *> *stack)
 {
-  list<Action> stack;
+  const vector<pair<const Action *, const list<Action> *> > *triggers;
   Event *evt;
 
   evt = act.event;
   g_assert_nonnull (evt);
 
   if (!ctx->getLinksStatus ())
-    return stack;
-  for (auto link : *ctx->getLinks ())
-    {
-      for (auto cond : link.first)
-        {
-          Predicate *pred;
+    return;
 
-          if (cond.event != evt || cond.transition != act.transition)
-            continue;
+  // Visit only the link conditions that match the action.
+  triggers = ctx->getLinksByCondition (evt, act.transition);
+  if (triggers == nullptr)
+    return;
 
-          pred = cond.predicate;
-          if (pred != nullptr && !this->evalPredicate (pred))
-            continue;
+  for (const auto &trigger : *triggers)
+    {
+      const Action *cond = trigger.first;
+      const list<Action> *acts = trigger.second;
+      Predicate *pred;
 
-          // Success.
-          auto acts = link.second;
-          for (auto ri = acts.rbegin (); ri != acts.rend (); ++ri)
-            {
-              Action next_act = *(ri);
-              string s;
-              Time delay;
+      pred = cond->predicate;
+      if (pred != nullptr && !this->evalPredicate (pred))
+        continue;
 
-              if (!this->evalPropertyRef (next_act.delay, &s))
-                {
-                  s = next_act.delay;
-                }
+      // Success.
+      for (auto ri = acts->rbegin (); ri != acts->rend (); ++ri)
+        {
+          const Action &next_act = *(ri);
+          Time delay;
 
-              delay = ginga::parse_time (s);
+          delay = this->evalParamAsTime (next_act.delay,
+                                         next_act.delayParam);
 
-              if (delay == 0 || delay == GINGA_TIME_NONE)
-                {
-                  stack.push_back (*ri);
-                }
-              else
-                {
-                  Event *next_evt = next_act.event;
-                  g_assert_nonnull (next_evt);
-                  Object *next_obj = next_evt->getObject ();
-                  g_assert_nonnull (next_obj);
+          if (delay == 0 || delay == GINGA_TIME_NONE)
+            {
+              stack->push_back (&next_act);
+            }
+          else
+            {
+              Event *next_evt = next_act.event;
+              g_assert_nonnull (next_evt);
+              Object *next_obj = next_evt->getObject ();
+              g_assert_nonnull (next_obj);
 
-                  ctx->addDelayedAction (next_evt, next_act.transition,
-                                         next_act.value, delay);
-                }
+              ctx->addDelayedAction (next_evt, next_act.transition,
+                                     next_act.value, delay);
             }
         }
     }
-  return stack;
 }
 
 /**
  * @brief Evaluates action over document.
  */
 int
-Document::evalAction (Action init)
+Document::evalAction (const Action &init)
 {
-  list<Action> stack;
+  vector<const Action *> stack;
   int n;
 
-  stack.push_back (init);
+  stack.push_back (&init);
   n = 0;
 
   while (!stack.empty ())
     {
-      Action act;
+      const Action *top;
       Event *evt;
       Object *obj;
       Composition *comp;
       Context *ctx_parent, *ctx_grandparent;
 
-      act = stack.back ();
+      top = stack.back ();
       stack.pop_back ();
+      const Action &act = *top;
 
       evt = act.event;
       g_assert_nonnull (evt);
@@ -300,9 +630,13 @@ Document::evalAction (Action init)
              Event::getEventTransitionAsString (act.transition).c_str (),
              act.event->getFullId ().c_str ());
 
-      evt->setParameter ("duration", act.duration);
+      // Only starting an attribution uses its duration.
       if (evt->getType () == Event::ATTRIBUTION)
-        evt->setParameter ("value", act.value);
+        evt->setAttributionValue (
+            this->evalParam (act.value, act.valueParam),
+            (act.transition == Event::START)
+                ? this->evalParamAsTime (act.duration, act.durationParam)
+                : 0);
 
       if (!evt->transition (act.transition))
         continue;
@@ -320,8 +654,7 @@ Document::evalAction (Action init)
           g_assert_nonnull (ctx_parent);
 
           // Trigger links in the parent context
-          list<Action> ret = evalActionInContext (act, ctx_parent);
-          stack.insert (stack.end (), ret.begin (), ret.end ());
+          this->evalActionInContext (act, ctx_parent, &stack);
 
           // If the event object is pointed by a port in the parent context,
           // trigger links in the its grantparent context ( and ancestors)
@@ -333,11 +666,8 @@ Document::evalAction (Action init)
               for (auto port : *ctx_parent->getPorts ())
                 {
                   if (port->getObject () == evt->getObject ())
-                    {
-                      list<Action> ret
-                          = evalActionInContext (act, ctx_grandparent);
-                      stack.insert (stack.end (), ret.begin (), ret.end ());
-                    }
+                    this->evalActionInContext (act, ctx_grandparent,
+                                               &stack);
                 }
             }
         }
@@ -372,8 +702,7 @@ Document::evalAction (Action init)
         {
           ctx_parent = cast (Context *, obj);
           g_assert_nonnull (ctx_parent);
-          list<Action> ret = evalActionInContext (act, ctx_parent);
-          stack.insert (stack.end (), ret.begin (), ret.end ());
+          this->evalActionInContext (act, ctx_parent, &stack);
         }
       // If have refer elements, trigger in the contexts
       else if (obj->getAliases ()->size ())
@@ -382,18 +711,95 @@ Document::evalAction (Action init)
             {
               ctx_parent = cast (Context *, alias.second);
               if (ctx_parent)
-                {
-                  list<Action> ret = evalActionInContext (act, ctx_parent);
-                  stack.insert (stack.end (), ret.begin (), ret.end ());
-                }
+                this->evalActionInContext (act, ctx_parent, &stack);
             }
         }
     }
   return n;
 }
 
+/**
+ * @brief Evaluates predicate.
+ *
+ * Runs the compiled form of predicate, compiling it first if necessary.
+ * Atomic tests compare their operands as numbers if both are numeric, and
+ * as strings otherwise.
+ *
+ * @param pred The predicate to evaluate.
+ * @return The resulting truth value.
+ */
 bool
 Document::evalPredicate (Predicate *pred)
+{
+  const vector<Predicate::Instr> *prog;
+  size_t pc;
+  bool acc;
+
+  g_assert_nonnull (pred);
+  prog = pred->getProgram ();
+  if (prog == nullptr)
+    {
+      this->compilePredicate (pred);
+      prog = pred->getProgram ();
+      g_assert_nonnull (prog);
+    }
+
+  acc = false;
+  pc = 0;
+  while (pc < prog->size ())
+    {
+      const Predicate::Instr &instr = (*prog)[pc++];
+      switch (instr.opcode)
+        {
+        case Predicate::Instr::CONST:
+          acc = instr.value;
+          break;
+        case Predicate::Instr::TEST:
+          {
+            string left_buf, right_buf;
+            const string *left, *right;
+            bool left_numeric, right_numeric;
+            double left_number, right_number;
+
+            left = this->evalPredicateOperand (instr.left, &left_buf,
+                                               &left_numeric, &left_number);
+            right = this->evalPredicateOperand (
+                instr.right, &right_buf, &right_numeric, &right_number);
+            acc = predicate_apply_test (instr.test, *left, left_numeric,
+                                        left_number, *right, right_numeric,
+                                        right_number);
+            break;
+          }
+        case Predicate::Instr::NOT:
+          acc = !acc;
+          break;
+        case Predicate::Instr::JUMP_IF_FALSE:
+          if (!acc)
+            pc = instr.target;
+          break;
+        case Predicate::Instr::JUMP_IF_TRUE:
+          if (acc)
+            pc = instr.target;
+          break;
+        default:
+          g_assert_not_reached ();
+        }
+    }
+  return acc;
+}
+
+/**
+ * @brief Evaluates predicate tree.
+ *
+ * This is the reference evaluator: it walks the predicate tree and
+ * resolves property references by id each time it is called.  Compare
+ * with evalPredicate(), which runs the compiled form of predicate.
+ *
+ * @param pred The predicate to evaluate.
+ * @return The resulting truth value.
+ */
+bool
+Document::evalPredicateTree (Predicate *pred)
 {
   switch (pred->getType ())
     {
@@ -410,6 +816,7 @@ Document::evalPredicate (Predicate *pred)
         string left, right;
         Predicate::Test test;
         string msg_left, msg_test, msg_right;
+        double left_number = 0, right_number = 0;
         bool result;
 
         pred->getTest (&left, &test, &right);
@@ -440,43 +847,53 @@ Document::evalPredicate (Predicate *pred)
           {
           case Predicate::EQ:
             msg_test = "==";
-            result = left == right;
             break;
           case Predicate::NE:
             msg_test = "!=";
-            result = left != right;
             break;
           case Predicate::LT:
             msg_test = "<";
-            result = left < right;
             break;
           case Predicate::LE:
             msg_test = "<=";
-            result = left <= right;
             break;
           case Predicate::GT:
             msg_test = ">";
-            result = left > right;
             break;
           case Predicate::GE:
             msg_test = ">=";
-            result = left >= right;
             break;
           default:
             g_assert_not_reached ();
           }
+        result = predicate_apply_test (
+            test, left, predicate_parse_number (left, &left_number),
+            left_number, right,
+            predicate_parse_number (right, &right_number), right_number);
         TRACE ("%s %s %s -> %s", msg_left.c_str (), msg_test.c_str (),
                msg_right.c_str (), strbool (result));
         return result;
       }
     case Predicate::NEGATION:
-      g_assert_not_reached ();
+      {
+        // not(p1, ..., pn) is evaluated as not(and(p1, ..., pn)).
+        for (auto child : *pred->getChildren ())
+          {
+            if (!this->evalPredicateTree (child))
+              {
+                TRACE ("not -> true");
+                return true;
+              }
+          }
+        TRACE ("not -> false");
+        return false;
+      }
       break;
     case Predicate::CONJUNCTION:
       {
         for (auto child : *pred->getChildren ())
           {
-            if (!this->evalPredicate (child))
+            if (!this->evalPredicateTree (child))
               {
                 TRACE ("and -> false");
                 return false;
@@ -490,7 +907,7 @@ Document::evalPredicate (Predicate *pred)
       {
         for (auto child : *pred->getChildren ())
           {
-            if (this->evalPredicate (child))
+            if (this->evalPredicateTree (child))
               {
                 TRACE ("or -> true");
                 return true;
@@ -527,6 +944,45 @@ Document::evalPropertyRef (const string &ref, string *result)
   return true;
 }
 
+/**
+ * @brief Compiles the parameters of action.
+ *
+ * This function is called by the parser once the document is complete,
+ * i.e., once all objects referenced by action parameters exist.  Compiled
+ * actions can be fired without parsing their parameters again.
+ *
+ * @param act The action to compile.
+ */
+void
+Document::compileAction (Action *act)
+{
+  g_assert_nonnull (act);
+  this->compileParam (act->value, &act->valueParam);
+  this->compileParam (act->duration, &act->durationParam);
+  this->compileParam (act->delay, &act->delayParam);
+}
+
+/**
+ * @brief Compiles predicate.
+ *
+ * Flattens the predicate tree into a sequence of instructions with
+ * property references resolved to objects and numeric literals parsed in
+ * advance.  References to objects that do not exist yet are kept as text
+ * and resolved by evalPredicate() each time it runs.  The compiled form is
+ * discarded by the predicate itself whenever it changes.
+ *
+ * @param pred The predicate to compile.
+ */
+void
+Document::compilePredicate (Predicate *pred)
+{
+  vector<Predicate::Instr> prog;
+
+  g_assert_nonnull (pred);
+  this->compilePredicateTree (pred, &prog);
+  pred->setProgram (prog);
+}
+
 bool
 Document::getData (const string &key, void **value)
 {
@@ -539,4 +995,215 @@ Document::setData (const string &key, void *value, UserDataCleanFunc fn)
   return _udata.setData (key, value, fn);
 }
 
+// Document: private.
+
+/**
+ * @brief Compiles action parameter.
+ * @param text The parameter text, a literal or a property reference.
+ * @param param The compiled parameter.
+ */
+void
+Document::compileParam (const string &text, ActionParam *param)
+{
+  size_t i;
+  Object *object;
+  Time time;
+
+  g_assert_nonnull (param);
+  param->compiled = true;
+  param->object = nullptr;
+  param->name = "";
+  param->time = GINGA_TIME_NONE;
+
+  if (text[0] == '$' && (i = text.find ('.')) != string::npos
+      && (object = this->getObjectByIdOrAlias (text.substr (1, i - 1)))
+             != nullptr)
+    {
+      param->object = object;
+      param->name = text.substr (i + 1);
+    }
+  else if (ginga::try_parse_time (text, &time))
+    {
+      param->time = time;
+    }
+}
+
+/**
+ * @brief Evaluates action parameter.
+ * @param text The parameter text.
+ * @param param The compiled parameter (may be not compiled).
+ * @return The value of the referenced property, or \p text itself if it is
+ * a literal.
+ */
+string
+Document::evalParam (const string &text, const ActionParam &param)
+{
+  string result;
+
+  if (!param.compiled)
+    return this->evalPropertyRef (text, &result) ? result : text;
+
+  if (param.object != nullptr)
+    return param.object->getProperty (param.name);
+
+  return text;
+}
+
+/**
+ * @brief Appends the compiled form of predicate tree to program.
+ * @param pred The predicate tree.
+ * @param prog The program.
+ */
+void
+Document::compilePredicateTree (Predicate *pred,
+                                vector<Predicate::Instr> *prog)
+{
+  Predicate::Instr instr;
+  Predicate::Instr::Opcode jump;
+  const list<Predicate *> *children;
+  vector<size_t> fixups;
+  size_t n;
+
+  switch (pred->getType ())
+    {
+    case Predicate::FALSUM:
+    case Predicate::VERUM:
+      instr.opcode = Predicate::Instr::CONST;
+      instr.value = pred->getType () == Predicate::VERUM;
+      prog->push_back (instr);
+      return;
+    case Predicate::ATOM:
+      {
+        string left, right;
+        instr.opcode = Predicate::Instr::TEST;
+        pred->getTest (&left, &instr.test, &right);
+        this->compilePredicateOperand (left, &instr.left);
+        this->compilePredicateOperand (right, &instr.right);
+        prog->push_back (instr);
+        return;
+      }
+    case Predicate::NEGATION:
+    case Predicate::CONJUNCTION:
+      jump = Predicate::Instr::JUMP_IF_FALSE;
+      break;
+    case Predicate::DISJUNCTION:
+      jump = Predicate::Instr::JUMP_IF_TRUE;
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+
+  // Short-circuit: after each child but the last, jump to the end if the
+  // result is already known.
+  children = pred->getChildren ();
+  if (children->empty ())
+    {
+      instr.opcode = Predicate::Instr::CONST;
+      instr.value = pred->getType () != Predicate::DISJUNCTION;
+      prog->push_back (instr);
+    }
+  n = 0;
+  for (auto child : *children)
+    {
+      this->compilePredicateTree (child, prog);
+      if (++n < children->size ())
+        {
+          instr.opcode = jump;
+          fixups.push_back (prog->size ());
+          prog->push_back (instr);
+        }
+    }
+  for (auto i : fixups)
+    (*prog)[i].target = prog->size ();
+
+  if (pred->getType () == Predicate::NEGATION)
+    {
+      instr.opcode = Predicate::Instr::NOT;
+      prog->push_back (instr);
+    }
+}
+
+/**
+ * @brief Compiles operand of atomic test.
+ * @param text The operand text, a literal or a property reference.
+ * @param op The compiled operand.
+ */
+void
+Document::compilePredicateOperand (const string &text,
+                                   Predicate::Operand *op)
+{
+  size_t i;
+  Object *object;
+
+  g_assert_nonnull (op);
+  op->text = text;
+  op->object = nullptr;
+  op->name = "";
+  op->ref = false;
+  op->numeric = false;
+  op->number = 0;
+
+  if (text[0] != '$')
+    {
+      op->numeric = predicate_parse_number (text, &op->number);
+    }
+  else if ((i = text.find ('.')) != string::npos
+           && (object = this->getObjectByIdOrAlias (text.substr (1, i - 1)))
+                  != nullptr)
+    {
+      op->object = object;
+      op->name = text.substr (i + 1);
+    }
+  else
+    {
+      op->ref = true;
+    }
+}
+
+/**
+ * @brief Evaluates operand of atomic test.
+ * @param op The compiled operand.
+ * @param buf Buffer to store the value of referenced property.
+ * @param numeric Variable to store whether the value is a number.
+ * @param number Variable to store the value as number.
+ * @return The operand value, either \p buf or the literal text of \p op.
+ */
+const string *
+Document::evalPredicateOperand (const Predicate::Operand &op, string *buf,
+                                bool *numeric, double *number)
+{
+  if (op.object != nullptr)
+    {
+      *buf = op.object->getProperty (op.name);
+      *numeric = predicate_parse_number (*buf, number);
+      return buf;
+    }
+
+  if (op.ref && this->evalPropertyRef (op.text, buf))
+    {
+      *numeric = predicate_parse_number (*buf, number);
+      return buf;
+    }
+
+  *numeric = op.numeric;
+  *number = op.number;
+  return &op.text;
+}
+
+/**
+ * @brief Evaluates action parameter as time.
+ * @param text The parameter text.
+ * @param param The compiled parameter (may be not compiled).
+ * @return The resulting time.
+ */
+Time
+Document::evalParamAsTime (const string &text, const ActionParam &param)
+{
+  if (param.compiled && param.object == nullptr
+      && GINGA_TIME_IS_VALID (param.time))
+    return param.time;
+
+  return ginga::parse_time (this->evalParam (text, param));
+}
+
 GINGA_NAMESPACE_END
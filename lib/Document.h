@@ -26,6 +26,41 @@ class Context;
 class Media;
 class Switch;
 
+/**
+ * @brief Intrusive list of objects.
+ *
+ * Objects are linked through their own #ObjectListLink, so that insertion
+ * and removal take constant time and do not allocate memory.  The list can
+ * be modified while it is being walked: objects removed during the walk
+ * are not visited, and objects inserted during the walk are visited only
+ * by the next walk.
+ */
+class ObjectList
+{
+public:
+  explicit ObjectList (int);
+
+  size_t size ();
+  bool contains (Object *);
+  bool insert (Object *);
+  bool remove (Object *);
+
+  Object *getFirst ();
+  Object *getNext (Object *);
+
+  Object *walkFirst ();
+  Object *walkNext ();
+
+private:
+  int _index;         ///< Index of object link used by list.
+  Object *_head;      ///< First object in list.
+  Object *_tail;      ///< Last object in list.
+  size_t _size;       ///< Number of objects in list.
+  guint64 _stamp;     ///< Last insertion stamp.
+  Object *_cursor;    ///< Next object to be visited by current walk.
+  guint64 _walkStamp; ///< Insertion stamp at the start of current walk.
+};
+
 /**
  * @brief NCL document.
  *
@@ -41,6 +76,7 @@ public:
   Object *getObjectById (const string &);
   Object *getObjectByIdOrAlias (const string &);
   bool addObject (Object *);
+  void addObjectAlias (Object *, const string &);
 
   Context *getRoot ();
   MediaSettings *getSettings ();
@@ -48,23 +84,43 @@ public:
   const set<Context *> *getContexts ();
   const set<Switch *> *getSwitches ();
 
+  ObjectList *getAwakeObjects ();
+  ObjectList *getOccurringObjects ();
+  void updateActiveObject (Object *);
+  void removeActiveObject (Object *);
+  Time getTimeToNextDeadline ();
+
   int evalAction (Event *, Event::Transition, const string &value = "");
-  int evalAction (Action);
+  int evalAction (const Action &);
   bool evalPredicate (Predicate *);
+  bool evalPredicateTree (Predicate *);
   bool evalPropertyRef (const string &, string *);
+  void compileAction (Action *);
+  void compilePredicate (Predicate *);
 
   bool getData (const string &, void **);
   bool setData (const string &, void *, UserDataCleanFunc fn = nullptr);
 
 private:
-  list<Action> evalActionInContext (Action, Context *);
+  void evalActionInContext (const Action &, Context *,
+                            vector<const Action *> *);
+  void compileParam (const string &, ActionParam *);
+  string evalParam (const string &, const ActionParam &);
+  Time evalParamAsTime (const string &, const ActionParam &);
+  void compilePredicateTree (Predicate *, vector<Predicate::Instr> *);
+  void compilePredicateOperand (const string &, Predicate::Operand *);
+  const string *evalPredicateOperand (const Predicate::Operand &, string *,
+                                     bool *, double *);
   set<Object *> _objects;             ///< Objects.
-  map<string, Object *> _objectsById; ///< Objects indexed by id.
+  unordered_map<string, Object *> _objectsById;    ///< Objects by id.
+  unordered_map<string, Object *> _objectsByAlias; ///< Objects by alias.
   Context *_root;                     ///< Root context (body).
   MediaSettings *_settings;           ///< Settings object.
   set<Media *> _medias;               ///< Media objects.
   set<Context *> _contexts;           ///< Context objects.
   set<Switch *> _switches;            ///< Switch objects.
+  ObjectList _awake;                  ///< Objects not sleeping.
+  ObjectList _occurring;              ///< Objects occurring.
   UserData _udata;                    ///< Attached user data.
 };
 
@@ -0,0 +1,1008 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "aux-ginga.h"
+#include "DocumentCache.h"
+
+#include "Context.h"
+#include "Media.h"
+#include "MediaSettings.h"
+#include "Parser.h"
+#include "Switch.h"
+
+GINGA_NAMESPACE_BEGIN
+
+/// Magic number of cache files.
+#define CACHE_MAGIC "GNCB"
+
+/// Version of cache file format.
+#define CACHE_VERSION 2
+
+/// Suffix appended to the NCL file path to obtain the cache file path.
+#define CACHE_SUFFIX ".gcache"
+
+/// Object index standing for "no object".
+#define CACHE_NONE G_MAXUINT32
+
+/// Predicate type standing for "no predicate".
+#define CACHE_NO_PREDICATE G_MAXUINT8
+
+/// Object kinds.
+enum
+{
+  CACHE_ROOT = 0, ///< The root context.
+  CACHE_SETTINGS, ///< The settings object.
+  CACHE_CONTEXT,  ///< Context.
+  CACHE_SWITCH,   ///< Switch.
+  CACHE_MEDIA,    ///< Media.
+};
+
+/// Index of objects being saved.
+typedef map<Object *, guint32> CacheIndex;
+
+/// Cursor over the contents of the cache file being loaded.
+typedef struct CacheReader
+{
+  const char *p;   ///< Current position.
+  const char *end; ///< End of contents.
+} CacheReader;
+
+// Helper functions.
+
+/// Gets the URI of the NCL file \p path as computed by Parser::parseFile().
+static string
+cache_uri_from_path (const string &path)
+{
+  string uri = path;
+  if (!xpathisabs (path))
+    uri = xpathmakeabs (path);
+  return xurifromsrc (uri, "");
+}
+
+/// Gets the modification time (in microseconds) and size of \p uri.
+static bool
+cache_stat_uri (const string &uri, guint64 *mtime, guint64 *size)
+{
+  GFile *file;
+  GFileInfo *info;
+
+  file = g_file_new_for_uri (uri.c_str ());
+  g_assert_nonnull (file);
+  info = g_file_query_info (file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC ","
+                            G_FILE_ATTRIBUTE_STANDARD_SIZE,
+                            G_FILE_QUERY_INFO_NONE, nullptr, nullptr);
+  g_object_unref (file);
+  if (info == nullptr)
+    return false;
+
+  *mtime = g_file_info_get_attribute_uint64 (info,
+                                             G_FILE_ATTRIBUTE_TIME_MODIFIED)
+               * G_USEC_PER_SEC
+           + g_file_info_get_attribute_uint32 (
+                 info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+  *size = (guint64) g_file_info_get_size (info);
+  g_object_unref (info);
+  return true;
+}
+
+/// Computes the hash of the contents of \p uri.
+static bool
+cache_hash_uri (const string &uri, string *hash)
+{
+  string data;
+  gchar *str;
+
+  if (unlikely (!xurigetcontents (uri, data)))
+    return false;
+
+  str = g_compute_checksum_for_data (
+      G_CHECKSUM_SHA1, (const guchar *) data.data (), data.length ());
+  g_assert_nonnull (str);
+  hash->assign (str);
+  g_free (str);
+  return true;
+}
+
+// Writing.
+
+static void
+cache_put_u8 (string *buf, guint8 x)
+{
+  buf->push_back ((char) x);
+}
+
+static void
+cache_put_u32 (string *buf, guint32 x)
+{
+  x = GUINT32_TO_LE (x);
+  buf->append ((const char *) &x, sizeof (x));
+}
+
+static void
+cache_put_u64 (string *buf, guint64 x)
+{
+  x = GUINT64_TO_LE (x);
+  buf->append ((const char *) &x, sizeof (x));
+}
+
+static void
+cache_put_str (string *buf, const string &s)
+{
+  cache_put_u32 (buf, (guint32) s.length ());
+  buf->append (s);
+}
+
+static void
+cache_put_map (string *buf, const map<string, string> *m)
+{
+  cache_put_u32 (buf, (guint32) m->size ());
+  for (auto &it : *m)
+    {
+      cache_put_str (buf, it.first);
+      cache_put_str (buf, it.second);
+    }
+}
+
+static void
+cache_put_object (string *buf, const CacheIndex &index, Object *obj)
+{
+  if (obj == nullptr)
+    {
+      cache_put_u32 (buf, CACHE_NONE);
+      return;
+    }
+  auto it = index.find (obj);
+  g_assert (it != index.end ());
+  cache_put_u32 (buf, it->second);
+}
+
+static void
+cache_put_event (string *buf, const CacheIndex &index, Event *evt)
+{
+  g_assert_nonnull (evt);
+  cache_put_object (buf, index, evt->getObject ());
+  cache_put_u8 (buf, (guint8) evt->getType ());
+  cache_put_str (buf, evt->getId ());
+}
+
+static void
+cache_put_predicate (string *buf, Predicate *pred)
+{
+  if (pred == nullptr)
+    {
+      cache_put_u8 (buf, CACHE_NO_PREDICATE);
+      return;
+    }
+
+  cache_put_u8 (buf, (guint8) pred->getType ());
+  switch (pred->getType ())
+    {
+    case Predicate::FALSUM:
+    case Predicate::VERUM:
+      break;
+    case Predicate::ATOM:
+      {
+        string left, right;
+        Predicate::Test test;
+        pred->getTest (&left, &test, &right);
+        cache_put_u8 (buf, (guint8) test);
+        cache_put_str (buf, left);
+        cache_put_str (buf, right);
+        break;
+      }
+    case Predicate::NEGATION:
+    case Predicate::CONJUNCTION:
+    case Predicate::DISJUNCTION:
+      cache_put_u32 (buf, (guint32) pred->getChildren ()->size ());
+      for (auto child : *pred->getChildren ())
+        cache_put_predicate (buf, child);
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+}
+
+static void
+cache_put_action (string *buf, const CacheIndex &index, const Action &act)
+{
+  cache_put_event (buf, index, act.event);
+  cache_put_u8 (buf, (guint8) act.transition);
+  cache_put_predicate (buf, act.predicate);
+  cache_put_str (buf, act.value);
+  cache_put_str (buf, act.duration);
+  cache_put_str (buf, act.delay);
+}
+
+/// Collects \p obj and its descendants in pre-order.
+static void
+cache_collect (Object *obj, vector<Object *> *objs)
+{
+  Composition *comp;
+
+  objs->push_back (obj);
+  comp = cast (Composition *, obj);
+  if (comp == nullptr)
+    return;
+
+  for (auto child : *comp->getChildren ())
+    cache_collect (child, objs);
+}
+
+// Reading.
+
+static bool
+cache_get_u8 (CacheReader *r, guint8 *x)
+{
+  if (unlikely (r->end - r->p < 1))
+    return false;
+  *x = (guint8) *r->p++;
+  return true;
+}
+
+static bool
+cache_get_u32 (CacheReader *r, guint32 *x)
+{
+  if (unlikely (r->end - r->p < (ptrdiff_t) sizeof (*x)))
+    return false;
+  memcpy (x, r->p, sizeof (*x));
+  *x = GUINT32_FROM_LE (*x);
+  r->p += sizeof (*x);
+  return true;
+}
+
+static bool
+cache_get_u64 (CacheReader *r, guint64 *x)
+{
+  if (unlikely (r->end - r->p < (ptrdiff_t) sizeof (*x)))
+    return false;
+  memcpy (x, r->p, sizeof (*x));
+  *x = GUINT64_FROM_LE (*x);
+  r->p += sizeof (*x);
+  return true;
+}
+
+static bool
+cache_get_str (CacheReader *r, string *s)
+{
+  guint32 len;
+
+  if (unlikely (!cache_get_u32 (r, &len)))
+    return false;
+  if (unlikely (r->end - r->p < (ptrdiff_t) len))
+    return false;
+  s->assign (r->p, len);
+  r->p += len;
+  return true;
+}
+
+static bool
+cache_get_object (CacheReader *r, const vector<Object *> &objs,
+                  Object **obj)
+{
+  guint32 i;
+
+  if (unlikely (!cache_get_u32 (r, &i)))
+    return false;
+  if (i == CACHE_NONE)
+    {
+      *obj = nullptr;
+      return true;
+    }
+  if (unlikely (i >= objs.size ()))
+    return false;
+  *obj = objs[i];
+  return true;
+}
+
+static bool
+cache_get_event (CacheReader *r, const vector<Object *> &objs,
+                 Event **evt)
+{
+  Object *obj;
+  guint8 type;
+  string id;
+
+  if (unlikely (!cache_get_object (r, objs, &obj) || obj == nullptr
+                || !cache_get_u8 (r, &type) || !cache_get_str (r, &id)))
+    {
+      return false;
+    }
+  *evt = obj->getEvent ((Event::Type) type, id);
+  return *evt != nullptr;
+}
+
+static bool
+cache_get_predicate (CacheReader *r, Predicate **pred)
+{
+  guint8 type;
+
+  *pred = nullptr;
+  if (unlikely (!cache_get_u8 (r, &type)))
+    return false;
+
+  switch (type)
+    {
+    case CACHE_NO_PREDICATE:
+      return true;
+    case Predicate::FALSUM:
+    case Predicate::VERUM:
+      *pred = new Predicate ((Predicate::Type) type);
+      return true;
+    case Predicate::ATOM:
+      {
+        guint8 test;
+        string left, right;
+        if (unlikely (!cache_get_u8 (r, &test) || test > Predicate::GE
+                      || !cache_get_str (r, &left)
+                      || !cache_get_str (r, &right)))
+          {
+            return false;
+          }
+        *pred = new Predicate (Predicate::ATOM);
+        (*pred)->setTest (left, (Predicate::Test) test, right);
+        return true;
+      }
+    case Predicate::NEGATION:
+    case Predicate::CONJUNCTION:
+    case Predicate::DISJUNCTION:
+      {
+        guint32 n;
+        if (unlikely (!cache_get_u32 (r, &n)))
+          return false;
+        *pred = new Predicate ((Predicate::Type) type);
+        for (guint32 i = 0; i < n; i++)
+          {
+            Predicate *child;
+            if (unlikely (!cache_get_predicate (r, &child)
+                          || child == nullptr))
+              {
+                delete *pred;
+                *pred = nullptr;
+                return false;
+              }
+            (*pred)->addChild (child);
+          }
+        return true;
+      }
+    default:
+      return false;
+    }
+}
+
+static bool
+cache_get_action (CacheReader *r, const vector<Object *> &objs,
+                  Action *act)
+{
+  guint8 transition;
+
+  act->predicate = nullptr;
+  if (unlikely (!cache_get_event (r, objs, &act->event)
+                || !cache_get_u8 (r, &transition)
+                || transition > Event::STOP
+                || !cache_get_predicate (r, &act->predicate)))
+    {
+      return false;
+    }
+  act->transition = (Event::Transition) transition;
+
+  if (unlikely (!cache_get_str (r, &act->value)
+                || !cache_get_str (r, &act->duration)
+                || !cache_get_str (r, &act->delay)))
+    {
+      delete act->predicate;
+      act->predicate = nullptr;
+      return false;
+    }
+  return true;
+}
+
+/// Checks the header of cache file against \p path and screen size.  A
+/// dependency whose modification time and size are those recorded in the
+/// header is taken as unchanged; only the others are hashed and compared
+/// with the recorded hash.
+static bool
+cache_check_header (CacheReader *r, const string &path, int width,
+                    int height, string *errmsg)
+{
+  guint32 version, w, h, n;
+  string uri;
+
+  if (unlikely (r->end - r->p < 4 || memcmp (r->p, CACHE_MAGIC, 4) != 0))
+    {
+      tryset (errmsg, "Bad cache file");
+      return false;
+    }
+  r->p += 4;
+
+  if (unlikely (!cache_get_u32 (r, &version) || version != CACHE_VERSION))
+    {
+      tryset (errmsg, "Unsupported cache file version");
+      return false;
+    }
+
+  if (unlikely (!cache_get_u32 (r, &w) || !cache_get_u32 (r, &h)
+                || !cache_get_u32 (r, &n)))
+    {
+      tryset (errmsg, "Bad cache file");
+      return false;
+    }
+
+  if (unlikely ((int) w != width || (int) h != height))
+    {
+      tryset (errmsg, "Stale cache file: screen size changed");
+      return false;
+    }
+
+  uri = cache_uri_from_path (path);
+  for (guint32 i = 0; i < n; i++)
+    {
+      string dep, hash, current;
+      guint64 mtime, size, cur_mtime, cur_size;
+
+      if (unlikely (!cache_get_str (r, &dep) || !cache_get_u64 (r, &mtime)
+                    || !cache_get_u64 (r, &size)
+                    || !cache_get_str (r, &hash)))
+        {
+          tryset (errmsg, "Bad cache file");
+          return false;
+        }
+      if (unlikely (i == 0 && dep != uri))
+        {
+          tryset (errmsg, "Stale cache file: source moved");
+          return false;
+        }
+      if (unlikely (!cache_stat_uri (dep, &cur_mtime, &cur_size)))
+        {
+          tryset (errmsg, "Stale cache file: " + dep + " changed");
+          return false;
+        }
+      if (likely (cur_mtime == mtime && cur_size == size))
+        continue;
+      if (unlikely (!cache_hash_uri (dep, &current) || current != hash))
+        {
+          tryset (errmsg, "Stale cache file: " + dep + " changed");
+          return false;
+        }
+    }
+
+  return true;
+}
+
+/// Reads the objects and their events (first section of cache file).
+static bool
+cache_read_objects (CacheReader *r, Document *doc, vector<Object *> *objs)
+{
+  guint32 n;
+
+  if (unlikely (!cache_get_u32 (r, &n) || n < 2))
+    return false;
+
+  for (guint32 i = 0; i < n; i++)
+    {
+      guint8 kind;
+      string id;
+      Object *obj;
+      Object *parent;
+      Composition *comp;
+      map<string, string> props;
+      guint32 nprops, nevts;
+
+      if (unlikely (!cache_get_u8 (r, &kind) || !cache_get_str (r, &id)
+                    || !cache_get_object (r, *objs, &parent)))
+        {
+          return false;
+        }
+
+      switch (kind)
+        {
+        case CACHE_ROOT:
+          if (unlikely (i != 0 || parent != nullptr))
+            return false;
+          obj = doc->getRoot ();
+          break;
+        case CACHE_SETTINGS:
+          obj = doc->getSettings ();
+          if (unlikely (parent != doc->getRoot () || id != obj->getId ()))
+            return false;
+          break;
+        case CACHE_CONTEXT:
+        case CACHE_SWITCH:
+        case CACHE_MEDIA:
+          comp = cast (Composition *, parent);
+          if (unlikely (comp == nullptr
+                        || doc->getObjectByIdOrAlias (id) != nullptr))
+            {
+              return false;
+            }
+          if (kind == CACHE_CONTEXT)
+            obj = new Context (id);
+          else if (kind == CACHE_SWITCH)
+            obj = new Switch (id);
+          else
+            obj = new Media (id);
+          comp->addChild (obj);
+          break;
+        default:
+          return false;
+        }
+      objs->push_back (obj);
+
+      // Properties.
+      if (unlikely (!cache_get_u32 (r, &nprops)))
+        return false;
+      for (guint32 j = 0; j < nprops; j++)
+        {
+          string name, value;
+          if (unlikely (!cache_get_str (r, &name)
+                        || !cache_get_str (r, &value)))
+            {
+              return false;
+            }
+          obj->setProperty (name, value);
+        }
+
+      // Events.
+      if (unlikely (!cache_get_u32 (r, &nevts)))
+        return false;
+      for (guint32 j = 0; j < nevts; j++)
+        {
+          guint8 type;
+          string evtId, label;
+          guint64 begin, end;
+          guint32 nparams;
+          Event *evt;
+
+          if (unlikely (!cache_get_u8 (r, &type)
+                        || !cache_get_str (r, &evtId)
+                        || !cache_get_u64 (r, &begin)
+                        || !cache_get_u64 (r, &end)
+                        || !cache_get_str (r, &label)
+                        || !cache_get_u32 (r, &nparams)))
+            {
+              return false;
+            }
+
+          switch (type)
+            {
+            case Event::ATTRIBUTION:
+              obj->addAttributionEvent (evtId);
+              break;
+            case Event::PRESENTATION:
+              obj->addPresentationEvent (evtId, begin, end);
+              break;
+            case Event::SELECTION:
+              obj->addSelectionEvent (evtId);
+              break;
+            default:
+              return false;
+            }
+
+          evt = obj->getEvent ((Event::Type) type, evtId);
+          g_assert_nonnull (evt);
+          evt->setInterval (begin, end);
+          if (label != "")
+            evt->setLabel (label);
+
+          for (guint32 k = 0; k < nparams; k++)
+            {
+              string name, value;
+              if (unlikely (!cache_get_str (r, &name)
+                            || !cache_get_str (r, &value)))
+                {
+                  return false;
+                }
+              evt->setParameter (name, value);
+            }
+        }
+    }
+
+  return true;
+}
+
+/// Reads the aliases of objects (second section of cache file).
+static bool
+cache_read_aliases (CacheReader *r, const vector<Object *> &objs)
+{
+  for (auto obj : objs)
+    {
+      guint32 n;
+
+      if (unlikely (!cache_get_u32 (r, &n)))
+        return false;
+
+      for (guint32 i = 0; i < n; i++)
+        {
+          string alias;
+          Object *parent;
+
+          if (unlikely (!cache_get_str (r, &alias)
+                        || !cache_get_object (r, objs, &parent)))
+            {
+              return false;
+            }
+          if (unlikely (parent != nullptr
+                        && !instanceof (Composition *, parent)))
+            {
+              return false;
+            }
+          obj->addAlias (alias, cast (Composition *, parent));
+        }
+    }
+
+  return true;
+}
+
+/// Reads context ports and links, and switch rules and ports (third
+/// section of cache file).
+static bool
+cache_read_structure (CacheReader *r, Document *doc,
+                      const vector<Object *> &objs)
+{
+  for (auto obj : objs)
+    {
+      Context *ctx;
+      Switch *swtch;
+      guint32 n;
+
+      if ((ctx = cast (Context *, obj)) != nullptr)
+        {
+          // Ports.
+          if (unlikely (!cache_get_u32 (r, &n)))
+            return false;
+          for (guint32 i = 0; i < n; i++)
+            {
+              Event *evt;
+              if (unlikely (!cache_get_event (r, objs, &evt)))
+                return false;
+              ctx->addPort (evt);
+            }
+
+          // Links.
+          if (unlikely (!cache_get_u32 (r, &n)))
+            return false;
+          for (guint32 i = 0; i < n; i++)
+            {
+              list<Action> conds;
+              list<Action> acts;
+              list<Action> *lists[2] = { &conds, &acts };
+
+              for (auto lst : lists)
+                {
+                  guint32 m;
+                  if (unlikely (!cache_get_u32 (r, &m) || m == 0))
+                    return false;
+                  for (guint32 j = 0; j < m; j++)
+                    {
+                      Action act;
+                      if (unlikely (!cache_get_action (r, objs, &act)))
+                        return false;
+                      doc->compileAction (&act);
+                      lst->push_back (act);
+                    }
+                }
+              ctx->addLink (conds, acts);
+            }
+        }
+      else if ((swtch = cast (Switch *, obj)) != nullptr)
+        {
+          // Rules.
+          if (unlikely (!cache_get_u32 (r, &n)))
+            return false;
+          for (guint32 i = 0; i < n; i++)
+            {
+              Object *target;
+              Predicate *pred;
+              if (unlikely (!cache_get_object (r, objs, &target)
+                            || target == nullptr
+                            || !cache_get_predicate (r, &pred)))
+                {
+                  return false;
+                }
+              if (unlikely (pred == nullptr))
+                return false;
+              swtch->addRule (target, pred);
+            }
+
+          // Switch ports.
+          if (unlikely (!cache_get_u32 (r, &n)))
+            return false;
+          for (guint32 i = 0; i < n; i++)
+            {
+              string id;
+              guint32 m;
+              list<Event *> evts;
+
+              if (unlikely (!cache_get_str (r, &id)
+                            || !cache_get_u32 (r, &m)))
+                {
+                  return false;
+                }
+              for (guint32 j = 0; j < m; j++)
+                {
+                  Event *evt;
+                  if (unlikely (!cache_get_event (r, objs, &evt)))
+                    return false;
+                  evts.push_back (evt);
+                }
+              swtch->addSwitchPort (id, evts);
+            }
+        }
+    }
+
+  return true;
+}
+
+// Public.
+
+/**
+ * @brief Gets the path of the cache file of an NCL file.
+ * @param path NCL file path.
+ * @return Cache file path.
+ */
+string
+DocumentCache::getPath (const string &path)
+{
+  return path + CACHE_SUFFIX;
+}
+
+/**
+ * @brief Saves document into the cache file of the NCL file it was parsed
+ * from.
+ *
+ * The document must have been obtained by Parser::parseFile() from \p path,
+ * with the given screen size, and must not have been started yet.
+ *
+ * @param doc Document.
+ * @param path NCL file path.
+ * @param width Screen width (in pixels) used to parse the file.
+ * @param height Screen height (in pixels) used to parse the file.
+ * @param[out] errmsg Variable to store the error message (if any).
+ * @return \c true if successful, or \c false otherwise.
+ */
+bool
+DocumentCache::save (Document *doc, const string &path, int width,
+                     int height, string *errmsg)
+{
+  list<string> deps;
+  list<string> *imports;
+  vector<Object *> objs;
+  CacheIndex index;
+  string buf;
+  GError *err;
+
+  g_assert_nonnull (doc);
+  g_assert_cmpint (width, >, 0);
+  g_assert_cmpint (height, >, 0);
+
+  // Header: magic, version, screen size, and dependencies.
+  deps.push_back (cache_uri_from_path (path));
+  if (doc->getData ("imports", (void **) &imports))
+    deps.insert (deps.end (), imports->begin (), imports->end ());
+
+  buf.append (CACHE_MAGIC, 4);
+  cache_put_u32 (&buf, CACHE_VERSION);
+  cache_put_u32 (&buf, (guint32) width);
+  cache_put_u32 (&buf, (guint32) height);
+  cache_put_u32 (&buf, (guint32) deps.size ());
+  for (auto &dep : deps)
+    {
+      string hash;
+      guint64 mtime, size;
+      if (unlikely (!cache_stat_uri (dep, &mtime, &size)
+                    || !cache_hash_uri (dep, &hash)))
+        {
+          tryset (errmsg, "Cannot read " + dep);
+          return false;
+        }
+      cache_put_str (&buf, dep);
+      cache_put_u64 (&buf, mtime);
+      cache_put_u64 (&buf, size);
+      cache_put_str (&buf, hash);
+    }
+
+  // Index objects: parents always come before their children.
+  cache_collect (doc->getRoot (), &objs);
+  for (guint32 i = 0; i < objs.size (); i++)
+    index[objs[i]] = i;
+
+  // Objects, their properties, and their events.
+  cache_put_u32 (&buf, (guint32) objs.size ());
+  for (auto obj : objs)
+    {
+      if (obj == doc->getRoot ())
+        cache_put_u8 (&buf, CACHE_ROOT);
+      else if (obj == doc->getSettings ())
+        cache_put_u8 (&buf, CACHE_SETTINGS);
+      else if (instanceof (Context *, obj))
+        cache_put_u8 (&buf, CACHE_CONTEXT);
+      else if (instanceof (Switch *, obj))
+        cache_put_u8 (&buf, CACHE_SWITCH);
+      else if (instanceof (Media *, obj))
+        cache_put_u8 (&buf, CACHE_MEDIA);
+      else
+        g_assert_not_reached ();
+
+      cache_put_str (&buf, obj->getId ());
+      cache_put_object (&buf, index, obj->getParent ());
+      cache_put_map (&buf, obj->getProperties ());
+
+      cache_put_u32 (&buf, (guint32) obj->getEvents ()->size ());
+      for (auto evt : *obj->getEvents ())
+        {
+          Time begin, end;
+          evt->getInterval (&begin, &end);
+          cache_put_u8 (&buf, (guint8) evt->getType ());
+          cache_put_str (&buf, evt->getId ());
+          cache_put_u64 (&buf, begin);
+          cache_put_u64 (&buf, end);
+          cache_put_str (&buf, evt->hasLabel () ? evt->getLabel () : "");
+          cache_put_map (&buf, evt->getParameters ());
+        }
+    }
+
+  // Aliases.
+  for (auto obj : objs)
+    {
+      cache_put_u32 (&buf, (guint32) obj->getAliases ()->size ());
+      for (auto &alias : *obj->getAliases ())
+        {
+          cache_put_str (&buf, alias.first);
+          cache_put_object (&buf, index, alias.second);
+        }
+    }
+
+  // Context ports and links, and switch rules and ports.
+  for (auto obj : objs)
+    {
+      Context *ctx;
+      Switch *swtch;
+
+      if ((ctx = cast (Context *, obj)) != nullptr)
+        {
+          cache_put_u32 (&buf, (guint32) ctx->getPorts ()->size ());
+          for (auto port : *ctx->getPorts ())
+            cache_put_event (&buf, index, port);
+
+          cache_put_u32 (&buf, (guint32) ctx->getLinks ()->size ());
+          for (auto &link : *ctx->getLinks ())
+            {
+              cache_put_u32 (&buf, (guint32) link.first.size ());
+              for (auto &act : link.first)
+                cache_put_action (&buf, index, act);
+              cache_put_u32 (&buf, (guint32) link.second.size ());
+              for (auto &act : link.second)
+                cache_put_action (&buf, index, act);
+            }
+        }
+      else if ((swtch = cast (Switch *, obj)) != nullptr)
+        {
+          cache_put_u32 (&buf, (guint32) swtch->getRules ()->size ());
+          for (auto &rule : *swtch->getRules ())
+            {
+              cache_put_object (&buf, index, rule.first);
+              cache_put_predicate (&buf, rule.second);
+            }
+
+          cache_put_u32 (&buf, (guint32) swtch->getSwitchPorts ()->size ());
+          for (auto &port : *swtch->getSwitchPorts ())
+            {
+              cache_put_str (&buf, port.first);
+              cache_put_u32 (&buf, (guint32) port.second.size ());
+              for (auto evt : port.second)
+                cache_put_event (&buf, index, evt);
+            }
+        }
+    }
+
+  err = nullptr;
+  if (unlikely (!g_file_set_contents (DocumentCache::getPath (path).c_str (),
+                                      buf.data (), (gssize) buf.length (),
+                                      &err)))
+    {
+      g_assert_nonnull (err);
+      tryset (errmsg, string (err->message));
+      g_error_free (err);
+      return false;
+    }
+
+  return true;
+}
+
+/**
+ * @brief Loads document from the cache file of an NCL file.
+ *
+ * The cache file is memory-mapped and the document is built directly from
+ * it.  If the cache file does not exist, is stale, or is corrupted, the
+ * function fails; the caller should then parse the NCL file itself.
+ *
+ * @param path NCL file path.
+ * @param width Screen width (in pixels).
+ * @param height Screen height (in pixels).
+ * @param[out] errmsg Variable to store the error message (if any).
+ * @return The resulting #Document if successful, or null otherwise.
+ */
+Document *
+DocumentCache::load (const string &path, int width, int height,
+                     string *errmsg)
+{
+  GMappedFile *file;
+  GError *err;
+  CacheReader r;
+  Document *doc;
+  vector<Object *> objs;
+
+  err = nullptr;
+  file = g_mapped_file_new (DocumentCache::getPath (path).c_str (), FALSE,
+                            &err);
+  if (file == nullptr)
+    {
+      g_assert_nonnull (err);
+      tryset (errmsg, string (err->message));
+      g_error_free (err);
+      return nullptr;
+    }
+
+  r.p = g_mapped_file_get_contents (file);
+  r.end = r.p + g_mapped_file_get_length (file);
+
+  doc = nullptr;
+  if (unlikely (!cache_check_header (&r, path, width, height, errmsg)))
+    goto done;
+
+  doc = new Document ();
+  if (unlikely (!cache_read_objects (&r, doc, &objs)
+                || !cache_read_aliases (&r, objs)
+                || !cache_read_structure (&r, doc, objs) || r.p != r.end))
+    {
+      tryset (errmsg, "Bad cache file");
+      delete doc;
+      doc = nullptr;
+    }
+
+done:
+  g_mapped_file_unref (file);
+  return doc;
+}
+
+/**
+ * @brief Parses NCL file and saves the resulting document into its cache
+ * file.
+ * @param path NCL file path.
+ * @param width Screen width (in pixels).
+ * @param height Screen height (in pixels).
+ * @param[out] errmsg Variable to store the error message (if any).
+ * @return \c true if successful, or \c false otherwise.
+ */
+bool
+DocumentCache::precompile (const string &path, int width, int height,
+                           string *errmsg)
+{
+  Document *doc;
+  bool status;
+
+  doc = Parser::parseFile (path, width, height, errmsg);
+  if (unlikely (doc == nullptr))
+    return false;
+
+  status = DocumentCache::save (doc, path, width, height, errmsg);
+  delete doc;
+  return status;
+}
+
+GINGA_NAMESPACE_END
@@ -0,0 +1,47 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#ifndef DOCUMENT_CACHE_H
+#define DOCUMENT_CACHE_H
+
+#include "Document.h"
+
+GINGA_NAMESPACE_BEGIN
+
+/**
+ * @brief Precompiled document cache.
+ *
+ * Stores a fully resolved #Document (objects, events, links, switch rules,
+ * and properties) in a compact binary file, so that the document can be
+ * loaded without parsing its NCL source again.  The cache is keyed by the
+ * screen size and by the hashes of the NCL file and of the documents it
+ * imports; if any of these changes, the cache is stale and is not loaded.
+ * Files are hashed again only if their modification time or size differ
+ * from those recorded when the cache was saved.
+ */
+class DocumentCache
+{
+public:
+  static string getPath (const string &);
+  static bool save (Document *, const string &, int, int, string *);
+  static Document *load (const string &, int, int, string *);
+  static bool precompile (const string &, int, int, string *);
+};
+
+GINGA_NAMESPACE_END
+
+#endif // DOCUMENT_CACHE_H
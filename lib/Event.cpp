@@ -17,10 +17,26 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 #include "aux-ginga.h"
 #include "Event.h"
+
+#include "Document.h"
 #include "Object.h"
 
 GINGA_NAMESPACE_BEGIN
 
+// Keeps the active lists of the document up-to-date with the state of the
+// lambda event of object.
+static inline void
+update_active_object (Event *evt, Object *obj)
+{
+  Document *doc;
+
+  if (obj->getLambda () != evt)
+    return;
+  if ((doc = obj->getDocument ()) == nullptr)
+    return;
+  doc->updateActiveObject (obj);
+}
+
 // Public.
 
 Event::Event (Event::Type type, Object *object, const string &id)
@@ -32,6 +48,7 @@ Event::Event (Event::Type type, Object *object, const string &id)
   _state = Event::SLEEPING;
   _begin = 0;
   _end = GINGA_TIME_NONE;
+  _attrDuration = 0;
 }
 
 Event::~Event ()
@@ -162,6 +179,12 @@ Event::setLabel (const string &label)
   _label = label;
 }
 
+const map<string, string> *
+Event::getParameters ()
+{
+  return &_parameters;
+}
+
 bool
 Event::getParameter (const string &name, string *value)
 {
@@ -174,6 +197,35 @@ Event::setParameter (const string &name, const string &value)
   MAP_SET_IMPL (_parameters, name, value);
 }
 
+string
+Event::getAttributionValue ()
+{
+  return _attrValue;
+}
+
+Time
+Event::getAttributionDuration ()
+{
+  return _attrDuration;
+}
+
+/**
+ * @brief Sets the value and duration of the next attribution.
+ *
+ * This function is called by Document::evalAction() before the event is
+ * transitioned, with the parameters of the action already evaluated.
+ *
+ * @param value The resolved value to be set.
+ * @param dur The duration of the attribution.
+ */
+void
+Event::setAttributionValue (const string &value, Time dur)
+{
+  g_assert (GINGA_TIME_IS_VALID (dur));
+  _attrValue = value;
+  _attrDuration = dur;
+}
+
 /**
  * @brief Transitions event.
  * @param trans The desired transition.
@@ -217,11 +269,13 @@ Event::transition (Event::Transition trans)
 
   // Update event state.
   _state = next;
+  update_active_object (this, _object);
 
   // Finish transition.
   if (unlikely (!_object->afterTransition (this, trans)))
     {
       _state = curr;
+      update_active_object (this, _object);
       return false;
     }
 
@@ -232,6 +286,7 @@ void
 Event::reset ()
 {
   _state = Event::SLEEPING;
+  update_active_object (this, _object);
 }
 
 // Public: Static.
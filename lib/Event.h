@@ -95,9 +95,14 @@ public:
   std::string getLabel ();
   void setLabel (const std::string &);
 
+  const map<string, string> *getParameters ();
   bool getParameter (const string &, string *);
   bool setParameter (const string &, const string &);
 
+  string getAttributionValue ();
+  Time getAttributionDuration ();
+  void setAttributionValue (const string &, Time);
+
   bool transition (Event::Transition);
   void reset ();
 
@@ -116,8 +121,27 @@ private:
   Time _end;                       ///< End time.
   std::string _label;              ///< Label.
   map<string, string> _parameters; ///< Parameters.
+  string _attrValue;               ///< Value to set (if attribution).
+  Time _attrDuration;              ///< Duration of attribution.
 };
 
+/**
+ * @brief Compiled action parameter.
+ *
+ * Action parameters (value, duration, and delay) are either literals or
+ * references to object properties ("$id.name").  A compiled parameter
+ * holds the referenced object and property name, or the literal parsed as
+ * time, so that firing the action does not require parsing its parameters
+ * again.  The source text is kept in the #Action itself.
+ */
+typedef struct ActionParam
+{
+  bool compiled = false;       ///< Whether parameter was compiled.
+  Object *object = nullptr;    ///< Referenced object (if reference).
+  string name;                 ///< Referenced property (if reference).
+  Time time = GINGA_TIME_NONE; ///< Literal as time (if valid time).
+} ActionParam;
+
 /**
  * @brief Action.
  */
@@ -129,6 +153,9 @@ typedef struct
   string value;                 ///< Value to set (if attribution).
   string duration;              ///< Duration.
   string delay;                 ///< Delay.
+  ActionParam valueParam;       ///< Compiled value.
+  ActionParam durationParam;    ///< Compiled duration.
+  ActionParam delayParam;       ///< Compiled delay.
 } Action;
 
 GINGA_NAMESPACE_END
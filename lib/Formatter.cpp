@@ -25,7 +25,9 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 #include "Object.h"
 #include "Switch.h"
 
+#include "DocumentCache.h"
 #include "Parser.h"
+#include "PlayerImage.h"
 #include "PlayerText.h"
 
 /**
@@ -47,6 +49,11 @@ static GingaOptions opts_defaults = {
   false, // experimental
   false, // opengl
   "",    // background ("" == none)
+  32768, // imageCacheSize (32 MB)
+  false, // syncImageDecode
+  false, // streamingParse
+  false, // backgroundParse
+  false, // scaleVideo
 };
 
 // Option data.
@@ -68,14 +75,24 @@ typedef struct GingaOptionData
 
 // Option table.
 static map<string, GingaOptionData> opts_table = {
+  OPTS_ENTRY (backgroundParse, G_TYPE_BOOLEAN, BackgroundParse),
   OPTS_ENTRY (background, G_TYPE_STRING, Background),
   OPTS_ENTRY (debug, G_TYPE_BOOLEAN, Debug),
   OPTS_ENTRY (experimental, G_TYPE_BOOLEAN, Experimental),
   OPTS_ENTRY (height, G_TYPE_INT, Size),
+  OPTS_ENTRY (imageCacheSize, G_TYPE_INT, ImageCacheSize),
   OPTS_ENTRY (opengl, G_TYPE_BOOLEAN, OpenGL),
+  OPTS_ENTRY (scaleVideo, G_TYPE_BOOLEAN, ScaleVideo),
+  OPTS_ENTRY (streamingParse, G_TYPE_BOOLEAN, StreamingParse),
+  OPTS_ENTRY (syncImageDecode, G_TYPE_BOOLEAN, SyncImageDecode),
   OPTS_ENTRY (width, G_TYPE_INT, Size),
 };
 
+// Host wake-up callback; see Ginga::setWakeupCallback().
+static GMutex wakeup_mutex;
+static GingaWakeupFunc wakeup_func = nullptr;
+static void *wakeup_data = nullptr;
+
 // Indexes option table.
 static bool
 opts_table_index (const string &key, GingaOptionData **result)
@@ -87,9 +104,9 @@ opts_table_index (const string &key, GingaOptionData **result)
   return true;
 }
 
-// Compares the z-index and z-order of two media objects.
-static int
-zcmp (Media *a, Media *b)
+// Compares the z-index and z-order of two players.
+static bool
+zcmp (Player *a, Player *b)
 {
   int z1, zo1, z2, zo2;
 
@@ -100,15 +117,50 @@ zcmp (Media *a, Media *b)
   a->getZ (&z1, &zo1);
   b->getZ (&z2, &zo2);
 
-  if (z1 < z2)
-    return -1;
-  if (z1 > z2)
-    return 1;
-  if (zo1 < zo2)
-    return -1;
-  if (zo1 > zo2)
-    return 1;
-  return 0;
+  if (z1 != z2)
+    return z1 < z2;
+  return zo1 < zo2;
+}
+
+// Gets the clip region of cairo context.
+static cairo_region_t *
+cairox_region_create_from_clip (cairo_t *cr)
+{
+  cairo_rectangle_list_t *list;
+  cairo_region_t *region;
+
+  region = cairo_region_create ();
+  g_assert_nonnull (region);
+
+  list = cairo_copy_clip_rectangle_list (cr);
+  g_assert_nonnull (list);
+  if (list->status == CAIRO_STATUS_SUCCESS)
+    {
+      for (int i = 0; i < list->num_rectangles; i++)
+        {
+          cairo_rectangle_t *r = &list->rectangles[i];
+          Rect rect;
+          rect.x = (int) floor (r->x);
+          rect.y = (int) floor (r->y);
+          rect.width = (int) ceil (r->x + r->width) - rect.x;
+          rect.height = (int) ceil (r->y + r->height) - rect.y;
+          cairo_region_union_rectangle (region, &rect);
+        }
+    }
+  else // clip is not representable as a list of rectangles
+    {
+      double x1, y1, x2, y2;
+      Rect rect;
+      cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+      rect.x = (int) floor (x1);
+      rect.y = (int) floor (y1);
+      rect.width = (int) ceil (x2) - rect.x;
+      rect.height = (int) ceil (y2) - rect.y;
+      cairo_region_union_rectangle (region, &rect);
+    }
+  cairo_rectangle_list_destroy (list);
+
+  return region;
 }
 
 // Public: External API.
@@ -122,40 +174,12 @@ Formatter::getState ()
 bool
 Formatter::start (const string &file, string *errmsg)
 {
-  int w, h;
-  Event *evt;
-
   // This must be the first check.
   if (_state != GINGA_STATE_STOPPED)
     return false;
 
-  // Parse document.
   g_assert_null (_doc);
-  w = _opts.width;
-  h = _opts.height;
-  _doc = nullptr;
-
-#if defined WITH_LUA && WITH_LUA
-  if (xstrhassuffix (file, ".lua"))
-    {
-      _doc = ParserLua::parseFile (file, errmsg);
-      if (unlikely (_doc == nullptr))
-        return false;
-    }
-#endif
-
-  if (_doc == nullptr)
-    _doc = Parser::parseFile (file, w, h, errmsg);
-  if (unlikely (_doc == nullptr))
-    return false;
-
-  g_assert_nonnull (_doc);
-  _doc->setData ("formatter", (void *) this);
-
-  Context *root = _doc->getRoot ();
-  g_assert_nonnull (root);
-  MediaSettings *settings = _doc->getSettings ();
-  g_assert_nonnull (settings);
+  g_assert_null (_parseJob);
 
   // Initialize formatter variables.
   _docPath = file;
@@ -163,21 +187,50 @@ Formatter::start (const string &file, string *errmsg)
   _lastTickTotal = 0;
   _lastTickDiff = 0;
   _lastTickFrameNo = 0;
+  _startTime = (Time) g_get_monotonic_time () * GINGA_USECOND;
+  _firstFrameTime = GINGA_TIME_NONE;
+
+  // In background mode, the document is parsed by a detached thread
+  // while the host keeps drawing (the background) and ticking; it is
+  // started as a whole by the first tick after the thread finishes.  This
+  // keeps the host responsive, but the first frame still waits for the
+  // whole document to be parsed.
+  if (_opts.backgroundParse && !xstrhassuffix (file, ".lua"))
+    {
+      GThread *thread;
+
+      _parseJob = new ParseJob;
+      g_assert_nonnull (_parseJob);
+      _parseJob->refcount = 2; // formatter and thread
+      _parseJob->done = 0;
+      _parseJob->path = file;
+      _parseJob->width = _opts.width;
+      _parseJob->height = _opts.height;
+      _parseJob->streaming = _opts.streamingParse;
+      _parseJob->doc = nullptr;
+
+      Parser::init (); // libxml2 must be initialized before threads use it
+      thread = g_thread_new ("ginga-parser", parseThread, _parseJob);
+      g_assert_nonnull (thread);
+      g_thread_unref (thread); // detach
+      _state = GINGA_STATE_PLAYING;
+      this->damageAll ();
+      return true;
+    }
 
-  // Run document.
-  TRACE ("%s", file.c_str ());
-  evt = root->getLambda ();
-  g_assert_nonnull (evt);
-  if (_doc->evalAction (evt, Event::START) == 0)
+  // Parse document.
+  _doc = parseDocument (file, _opts.width, _opts.height,
+                        _opts.streamingParse, errmsg);
+  if (unlikely (_doc == nullptr))
     return false;
 
-  // Start settings.
-  evt = _doc->getSettings ()->getLambda ();
-  g_assert_nonnull (evt);
-  g_assert (evt->transition (Event::START));
+  // Run document.
+  if (unlikely (!this->startDocument ()))
+    return false;
 
   // Sets formatter state.
   _state = GINGA_STATE_PLAYING;
+  this->damageAll ();
 
   return true;
 }
@@ -189,8 +242,20 @@ Formatter::stop ()
   if (_state == GINGA_STATE_STOPPED)
     return false;
 
+  // Don't wait for the parse thread; it frees the job (and the document
+  // it parsed) when it finishes.
+  if (_parseJob != nullptr)
+    {
+      parseJobUnref (_parseJob);
+      _parseJob = nullptr;
+    }
+
   delete _doc;
   _doc = nullptr;
+  _displayList.clear ();
+  cairo_region_destroy (_damage);
+  _damage = cairo_region_create ();
+  g_assert_nonnull (_damage);
 
   _state = GINGA_STATE_STOPPED;
   return true;
@@ -207,6 +272,10 @@ Formatter::resize (int width, int height)
   if (_state != GINGA_STATE_PLAYING)
     return;
 
+  this->damageAll ();
+  if (_doc == nullptr) // still parsing
+    return;
+
   // Resize each media object in document.
   for (auto media : *_doc->getMedias ())
     {
@@ -229,20 +298,43 @@ Formatter::resize (int width, int height)
 void
 Formatter::redraw (cairo_t *cr)
 {
-  GList *zlist;
-  GList *l;
+  cairo_region_t *paint;
+  Rect screen;
 
   // This must be the first check.
   if (_state != GINGA_STATE_PLAYING)
     return;
 
+  // Only the part of the damaged area that is inside the clip region of
+  // the host is repainted; the rest remains pending.  Hosts should use
+  // Formatter::getDamage() to restrict the clip region to the damaged area.
+  this->collectDamage ();
+  screen = { 0, 0, _opts.width, _opts.height };
   if (_opts.opengl)
     {
+      paint = cairo_region_create_rectangle (&screen);
       GL::beginDraw ();
       GL::clear_scene (_opts.width, _opts.height);
     }
   else
     {
+      paint = cairox_region_create_from_clip (cr);
+      cairo_region_intersect_rectangle (paint, &screen);
+      if (cairo_region_is_empty (paint))
+        {
+          cairo_region_destroy (paint);
+          return; // nothing to do
+        }
+
+      cairo_save (cr);
+      for (int i = 0; i < cairo_region_num_rectangles (paint); i++)
+        {
+          Rect rect;
+          cairo_region_get_rectangle (paint, i, &rect);
+          cairo_rectangle (cr, rect.x, rect.y, rect.width, rect.height);
+        }
+      cairo_clip (cr);
+
       cairo_save (cr);
       cairo_set_source_rgba (cr, 0, 0, 0, 1.0);
       cairo_rectangle (cr, 0, 0, _opts.width, _opts.height);
@@ -270,19 +362,50 @@ Formatter::redraw (cairo_t *cr)
         }
     }
 
-  zlist = nullptr;
-  for (auto &media : *_doc->getMedias ())
-    zlist = g_list_insert_sorted (zlist, media, (GCompareFunc) zcmp);
+  // IMPORTANT: Updating a player may cause players to be started, stopped,
+  // or to have their z-index changed (e.g., NCLua players post events while
+  // updating).  We thus walk the display list by index and let
+  // displayListAdd() and displayListRemove() adjust the cursor whenever
+  // the list is modified behind it.
+  //
+  // Every player is updated, even if it is invisible or outside the
+  // painted area: NCLua scripts must keep running, animations must keep
+  // advancing, and video frames must keep being consumed.  Only the
+  // drawing is culled.
+  _displayListWalked = 0;
+  _displayListDrawn = 0;
+  for (_displayListCursor = 0;
+       _displayListCursor < (int) _displayList.size (); _displayListCursor++)
+    {
+      Player *player = _displayList[(size_t) _displayListCursor];
+      Rect rect;
+
+      g_assert (player->getState () != Player::SLEEPING);
+      _displayListWalked++;
+      player->update ();
+      if (player->getState () == Player::SLEEPING)
+        continue; // stopped while updating
+      if (!player->isVisible ())
+        continue;
+
+      rect = player->getRect ();
+      rect = { rect.x - 1, rect.y - 1, rect.width + 2, rect.height + 2 };
+      if (cairo_region_contains_rectangle (paint, &rect)
+          == CAIRO_REGION_OVERLAP_OUT)
+        continue;
+
+      player->redraw (cr);
+      _displayListDrawn++;
+    }
+  _displayListCursor = -1;
 
-  l = zlist;
-  while (l != NULL)
+  if (_firstFrameTime == GINGA_TIME_NONE && _displayListDrawn > 0)
     {
-      GList *next = l->next;
-      ((Media *) l->data)->redraw (cr);
-      zlist = g_list_delete_link (zlist, l);
-      l = next;
+      _firstFrameTime
+          = (Time) g_get_monotonic_time () * GINGA_USECOND - _startTime;
+      TRACE ("time-to-first-frame: %" GINGA_TIME_FORMAT,
+             GINGA_TIME_ARGS (_firstFrameTime));
     }
-  g_assert_null (zlist);
 
   if (_opts.debug)
     {
@@ -292,25 +415,67 @@ Formatter::redraw (cairo_t *cr)
       string info;
       cairo_surface_t *debug;
       Rect ink;
-      info = xstrbuild ("%s: #%lu %" GINGA_TIME_FORMAT " %.1ffps",
+      info = xstrbuild ("%s: #%lu %" GINGA_TIME_FORMAT " %.1ffps drawn:%u/%u",
                         _docPath.c_str (), _lastTickFrameNo,
                         GINGA_TIME_ARGS (_lastTickTotal),
-                        1 * GINGA_SECOND / (double) _lastTickDiff);
+                        1 * GINGA_SECOND / (double) _lastTickDiff,
+                        _displayListDrawn, _displayListWalked);
       rect.width = _opts.width;
       rect.height = _opts.height;
       debug = PlayerText::renderSurface (info, "monospace", "", "bold", "9",
                                          fg, bg, rect, "center", "", true,
                                          &ink);
       ink = { 0, 0, rect.width, ink.height - ink.y + 4 };
-      cairo_save (cr);
-      cairo_set_source_rgba (cr, 1., 0., 0., .5);
-      cairo_rectangle (cr, 0, 0, ink.width, ink.height);
-      cairo_fill (cr);
-      cairo_set_source_surface (cr, debug, 0, 0);
-      cairo_paint (cr);
-      cairo_restore (cr);
+      if (_opts.opengl)
+        {
+          GLuint gltex = 0;
+          int w = cairo_image_surface_get_width (debug);
+          int h = cairo_image_surface_get_height (debug);
+
+          cairo_surface_flush (debug);
+          GL::create_texture (&gltex, w, h,
+                              cairo_image_surface_get_data (debug));
+          GL::draw_quad (0, 0, ink.width, ink.height, 1.f, 0.f, 0.f, .5f);
+          GL::draw_quad (0, 0, w, h, gltex);
+          GL::delete_texture (&gltex);
+        }
+      else
+        {
+          cairo_save (cr);
+          cairo_set_source_rgba (cr, 1., 0., 0., .5);
+          cairo_rectangle (cr, 0, 0, ink.width, ink.height);
+          cairo_fill (cr);
+          cairo_set_source_surface (cr, debug, 0, 0);
+          cairo_paint (cr);
+          cairo_restore (cr);
+        }
       cairo_surface_destroy (debug);
+      _debugRect = ink;
     }
+
+  if (!_opts.opengl)
+    cairo_restore (cr);
+
+  cairo_region_subtract (_damage, paint);
+  cairo_region_destroy (paint);
+}
+
+bool
+Formatter::getDamage (cairo_region_t *region)
+{
+  Rect screen;
+
+  // This must be the first check.
+  if (_state != GINGA_STATE_PLAYING)
+    return false;
+
+  this->collectDamage ();
+  screen = { 0, 0, _opts.width, _opts.height };
+  cairo_region_intersect_rectangle (_damage, &screen);
+  if (region != nullptr)
+    cairo_region_union (region, _damage);
+
+  return !cairo_region_is_empty (_damage);
 }
 
 // Stops formatter if EOS has been seen.
@@ -337,24 +502,26 @@ Formatter::redraw (cairo_t *cr)
 bool
 Formatter::sendKey (const string &key, bool press)
 {
-  list<Object *> buf;
+  ObjectList *awake;
 
   // This must be the first check.
   if (_state != GINGA_STATE_PLAYING)
     return false;
+  if (_doc == nullptr) // still parsing
+    return true;
   _GINGA_CHECK_EOS (this);
   if (_state != GINGA_STATE_PLAYING)
     return false;
 
-  // IMPORTANT: When propagating a key to the objects, we cannot traverse
-  // the object set directly, as the reception of a key may cause this set
-  // to be modified.  We thus need to create a buffer with the objects that
-  // should receive the key, i.e., those that are not sleeping, and then
-  // propagate the key only to the objects in this buffer.
-  for (auto obj : *_doc->getObjects ())
-    if (!obj->isSleeping ())
-      buf.push_back (obj);
-  for (auto obj : buf)
+  // IMPORTANT: The reception of a key may cause objects to be started or
+  // stopped, i.e., to be inserted into or removed from the list of awake
+  // objects maintained by the document.  The walk over this list is safe
+  // against such modifications: the key is propagated only to the objects
+  // that were awake when the walk started and that are still awake when
+  // they are visited.
+  awake = _doc->getAwakeObjects ();
+  for (Object *obj = awake->walkFirst (); obj != nullptr;
+       obj = awake->walkNext ())
     obj->sendKey (key, press);
 
   return true;
@@ -363,11 +530,13 @@ Formatter::sendKey (const string &key, bool press)
 bool
 Formatter::sendTick (uint64_t total, uint64_t diff, uint64_t frame)
 {
-  list<Object *> buf;
+  ObjectList *occurring;
 
   // This must be the first check.
   if (_state != GINGA_STATE_PLAYING)
     return false;
+  if (_doc == nullptr && !this->attachDocument ())
+    return _state == GINGA_STATE_PLAYING;
   _GINGA_CHECK_EOS (this);
   if (_state != GINGA_STATE_PLAYING)
     return false;
@@ -377,17 +546,53 @@ Formatter::sendTick (uint64_t total, uint64_t diff, uint64_t frame)
   _lastTickFrameNo = frame;
 
   // IMPORTANT: The same warning about propagation that appear in
-  // Formatter::sendKeyEvent() applies here.  The difference is that ticks
+  // Formatter::sendKey() applies here.  The difference is that ticks
   // should only be propagated to objects that are occurring.
-  for (auto obj : *_doc->getObjects ())
-    if (obj->isOccurring ())
-      buf.push_back (obj);
-  for (auto obj : buf)
+  occurring = _doc->getOccurringObjects ();
+  for (Object *obj = occurring->walkFirst (); obj != nullptr;
+       obj = occurring->walkNext ())
     obj->sendTick (total, diff, frame);
 
+  this->updateOcclusion ();
   return true;
 }
 
+bool
+Formatter::getNextDeadline (uint64_t *delay, bool *redraw)
+{
+  Context *root;
+  Time next;
+
+  tryset (delay, GINGA_TIME_NONE);
+  tryset (redraw, false);
+
+  // This must be the first check.
+  if (_state != GINGA_STATE_PLAYING)
+    return false;
+
+  // While the document is being parsed, poll the parse thread.
+  if (_doc == nullptr)
+    {
+      tryset (delay, 10 * GINGA_MSECOND);
+      tryset (redraw, this->getDamage (nullptr));
+      return true;
+    }
+
+  // If the presentation has ended, the next tick stops the formatter.  If
+  // debugging is on, the info overlay changes on every frame.
+  root = _doc->getRoot ();
+  g_assert_nonnull (root);
+  if (_eos || root->isSleeping () || _opts.debug)
+    next = 0;
+  else
+    next = _doc->getTimeToNextDeadline ();
+
+  tryset (delay, next);
+  tryset (redraw, this->getDamage (nullptr));
+
+  return GINGA_TIME_IS_VALID (next);
+}
+
 const GingaOptions *
 Formatter::getOptions ()
 {
@@ -452,11 +657,28 @@ Formatter::Formatter (const GingaOptions *opts) : Ginga (opts)
   _docPath = "";
   _eos = false;
 
+  _displayListCursor = -1;
+  _displayListWalked = 0;
+  _displayListDrawn = 0;
+
+  _damage = cairo_region_create ();
+  g_assert_nonnull (_damage);
+  _debugRect = { 0, 0, 0, 0 };
+
+  _startTime = GINGA_TIME_NONE;
+  _firstFrameTime = GINGA_TIME_NONE;
+  _parseJob = nullptr;
+
   // Initialize options.
   setOptionBackground (this, "background", _opts.background);
   setOptionDebug (this, "debug", _opts.debug);
   setOptionExperimental (this, "experimental", _opts.experimental);
+  setOptionImageCacheSize (this, "imageCacheSize", _opts.imageCacheSize);
   setOptionOpenGL (this, "opengl", _opts.opengl);
+  setOptionSyncImageDecode (this, "syncImageDecode", _opts.syncImageDecode);
+  setOptionStreamingParse (this, "streamingParse", _opts.streamingParse);
+  setOptionBackgroundParse (this, "backgroundParse", _opts.backgroundParse);
+  setOptionScaleVideo (this, "scaleVideo", _opts.scaleVideo);
 }
 
 /**
@@ -465,6 +687,7 @@ Formatter::Formatter (const GingaOptions *opts) : Ginga (opts)
 Formatter::~Formatter ()
 {
   this->stop ();
+  cairo_region_destroy (_damage);
 }
 
 /**
@@ -477,6 +700,18 @@ Formatter::getDocument ()
   return _doc;
 }
 
+/**
+ * @brief Gets the time from the start of the presentation to the first
+ * frame that drew some player.
+ * @return Time-to-first-frame, or #GINGA_TIME_NONE if no such frame was
+ * drawn yet.
+ */
+Time
+Formatter::getTimeToFirstFrame ()
+{
+  return _firstFrameTime;
+}
+
 /**
  * @brief Gets EOS flag.
  * @return EOS flag.
@@ -497,6 +732,316 @@ Formatter::setEOS (bool eos)
   _eos = eos;
 }
 
+/**
+ * @brief Gets display list.
+ *
+ * The display list contains the players that are not sleeping, sorted by
+ * z-index and z-order, i.e., in the order they are drawn by
+ * Formatter::redraw().
+ *
+ * @return The display list.
+ */
+const vector<Player *> *
+Formatter::getDisplayList ()
+{
+  return &_displayList;
+}
+
+/**
+ * @brief Adds player to display list.
+ * @param player The player to add.
+ * @return \c true if successful, or \c false otherwise (already in list).
+ */
+bool
+Formatter::displayListAdd (Player *player)
+{
+  vector<Player *>::iterator it;
+  int index;
+
+  g_assert_nonnull (player);
+  if (std::find (_displayList.begin (), _displayList.end (), player)
+      != _displayList.end ())
+    return false;
+
+  it = std::upper_bound (_displayList.begin (), _displayList.end (), player,
+                         zcmp);
+  index = (int) (it - _displayList.begin ());
+  _displayList.insert (it, player);
+
+  // Keep redraw cursor pointing to the same player.
+  if (_displayListCursor >= 0 && index <= _displayListCursor)
+    _displayListCursor++;
+
+  return true;
+}
+
+/**
+ * @brief Removes player from display list.
+ * @param player The player to remove.
+ * @return \c true if successful, or \c false otherwise (not in list).
+ */
+bool
+Formatter::displayListRemove (Player *player)
+{
+  vector<Player *>::iterator it;
+  int index;
+
+  it = std::find (_displayList.begin (), _displayList.end (), player);
+  if (it == _displayList.end ())
+    return false;
+
+  index = (int) (it - _displayList.begin ());
+  _displayList.erase (it);
+
+  // Repaint the area previously covered by player.
+  player->damage ();
+  player->getDamage (_damage);
+
+  // Keep redraw cursor pointing to the same player.
+  if (_displayListCursor >= 0 && index <= _displayListCursor)
+    _displayListCursor--;
+
+  return true;
+}
+
+/**
+ * @brief Updates the position of player in display list.
+ *
+ * This function should be called whenever the z-index or z-order of \p
+ * player changes.  It does nothing if \p player is not in display list.
+ *
+ * @param player The player to update.
+ */
+void
+Formatter::displayListUpdate (Player *player)
+{
+  if (this->displayListRemove (player))
+    g_assert (this->displayListAdd (player));
+}
+
+/**
+ * @brief Marks area of the screen as damaged.
+ *
+ * The damaged area is repainted by the next call to Formatter::redraw().
+ *
+ * @param rect The area to mark as damaged.
+ */
+void
+Formatter::damage (const Rect &rect)
+{
+  cairo_region_union_rectangle (_damage, &rect);
+}
+
+/**
+ * @brief Marks the whole screen as damaged.
+ */
+void
+Formatter::damageAll ()
+{
+  this->damage ({ 0, 0, _opts.width, _opts.height });
+}
+
+/**
+ * @brief Sets the host wake-up callback.
+ * @param func Wake-up function, or null to disable wake-ups.
+ * @param data User data to pass to \p func.
+ */
+void
+Formatter::setWakeupCallback (GingaWakeupFunc func, void *data)
+{
+  g_mutex_lock (&wakeup_mutex);
+  wakeup_func = func;
+  wakeup_data = data;
+  g_mutex_unlock (&wakeup_mutex);
+}
+
+/**
+ * @brief Wakes up the host, so that it ticks the presentation.
+ *
+ * Called by background threads when they finish work that changes the
+ * presentation.  Can be called from any thread.
+ */
+void
+Formatter::wakeup ()
+{
+  g_mutex_lock (&wakeup_mutex);
+  if (wakeup_func != nullptr)
+    wakeup_func (wakeup_data);
+  g_mutex_unlock (&wakeup_mutex);
+}
+
+// Private.
+
+// Collects the damage of the players in display list and of the debugging
+// overlay into the damaged area of the formatter.
+void
+Formatter::collectDamage ()
+{
+  for (auto player : _displayList)
+    player->getDamage (_damage);
+
+  if (_opts.debug)
+    this->damage (_debugRect);
+}
+
+// Tells each player in display list whether it is hidden from screen.  The
+// display list is walked from top to bottom while keeping track of the
+// screen area not yet covered by opaque players; a player is hidden if it
+// is invisible or if its rect falls entirely outside this area.
+void
+Formatter::updateOcclusion ()
+{
+  cairo_region_t *uncovered;
+  Rect screen;
+
+  screen = { 0, 0, _opts.width, _opts.height };
+  uncovered = cairo_region_create_rectangle (&screen);
+  g_assert_nonnull (uncovered);
+
+  for (auto it = _displayList.rbegin (); it != _displayList.rend (); ++it)
+    {
+      Player *player = *it;
+      Rect rect = player->getRect ();
+
+      if (!player->isVisible () || rect.width <= 0 || rect.height <= 0
+          || cairo_region_contains_rectangle (uncovered, &rect)
+                 == CAIRO_REGION_OVERLAP_OUT)
+        {
+          player->setHidden (true);
+          continue;
+        }
+
+      player->setHidden (false);
+      if (player->isOpaque ())
+        cairo_region_subtract_rectangle (uncovered, &rect);
+    }
+
+  cairo_region_destroy (uncovered);
+}
+
+// Parses the document at the given file with the given screen size,
+// preferring its precompiled cache when it is fresh.  May be called from
+// the parse thread.
+Document *
+Formatter::parseDocument (const string &file, int w, int h, bool streaming,
+                          string *errmsg)
+{
+  Document *doc = nullptr;
+
+#if defined WITH_LUA && WITH_LUA
+  if (xstrhassuffix (file, ".lua"))
+    return ParserLua::parseFile (file, errmsg);
+#endif
+
+  // Use the precompiled document, if there is a fresh one.
+  string cachemsg;
+  doc = DocumentCache::load (file, w, h, &cachemsg);
+  if (doc != nullptr)
+    return doc;
+  TRACE ("no precompiled document: %s", cachemsg.c_str ());
+
+  if (streaming)
+    return Parser::parseFileStreaming (file, w, h, errmsg);
+  else
+    return Parser::parseFile (file, w, h, errmsg);
+}
+
+// Starts the presentation of the current document.
+bool
+Formatter::startDocument ()
+{
+  Event *evt;
+
+  g_assert_nonnull (_doc);
+  _doc->setData ("formatter", (void *) this);
+
+  Context *root = _doc->getRoot ();
+  g_assert_nonnull (root);
+  MediaSettings *settings = _doc->getSettings ();
+  g_assert_nonnull (settings);
+
+  // Run document.
+  TRACE ("%s", _docPath.c_str ());
+  evt = root->getLambda ();
+  g_assert_nonnull (evt);
+  if (_doc->evalAction (evt, Event::START) == 0)
+    return false;
+
+  // Start settings.
+  evt = settings->getLambda ();
+  g_assert_nonnull (evt);
+  g_assert (evt->transition (Event::START));
+
+  return true;
+}
+
+// Takes the document parsed by the parse thread, if it has finished, and
+// starts it.  Returns true if the document is attached and started.  If
+// parsing or starting failed, stops the formatter.
+bool
+Formatter::attachDocument ()
+{
+  string errmsg;
+
+  g_assert_null (_doc);
+  g_assert_nonnull (_parseJob);
+
+  if (!g_atomic_int_get (&_parseJob->done))
+    return false;
+
+  _doc = _parseJob->doc;
+  _parseJob->doc = nullptr;
+  errmsg = _parseJob->errmsg;
+  parseJobUnref (_parseJob);
+  _parseJob = nullptr;
+  TRACE ("document ready after %" GINGA_TIME_FORMAT,
+         GINGA_TIME_ARGS ((Time) g_get_monotonic_time () * GINGA_USECOND
+                          - _startTime));
+
+  if (unlikely (_doc == nullptr))
+    {
+      WARNING ("%s", errmsg.c_str ());
+      this->stop ();
+      return false;
+    }
+
+  if (unlikely (!this->startDocument ()))
+    {
+      this->stop ();
+      return false;
+    }
+
+  this->damageAll ();
+  return true;
+}
+
+// Drops a reference to the given parse job, freeing it (and the document
+// it holds) if this was the last one.
+void
+Formatter::parseJobUnref (ParseJob *job)
+{
+  g_assert_nonnull (job);
+  if (!g_atomic_int_dec_and_test (&job->refcount))
+    return;
+  delete job->doc;
+  delete job;
+}
+
+// Body of the parse thread.  Touches only the job, never the formatter,
+// which may already be gone.
+gpointer
+Formatter::parseThread (gpointer data)
+{
+  ParseJob *job = (ParseJob *) data;
+
+  job->doc = parseDocument (job->path, job->width, job->height,
+                            job->streaming, &job->errmsg);
+  g_atomic_int_set (&job->done, 1);
+  parseJobUnref (job);
+
+  return nullptr;
+}
+
 // Public: Static.
 
 /**
@@ -514,6 +1059,7 @@ Formatter::setOptionBackground (Formatter *self, const string &name,
     self->_background = { 0., 0., 0., 0. };
   else
     self->_background = ginga::parse_color (value);
+  self->damageAll ();
   TRACE ("%s:='%s'", name.c_str (), value.c_str ());
 }
 
@@ -539,6 +1085,7 @@ Formatter::setOptionDebug (Formatter *self, const string &name, bool value)
       g_assert (g_setenv ("G_MESSAGES_DEBUG",
                           self->_saved_G_MESSAGES_DEBUG.c_str (), true));
     }
+  self->damageAll ();
   TRACE ("%s:=%s", name.c_str (), strbool (value));
 }
 
@@ -556,6 +1103,21 @@ Formatter::setOptionExperimental (unused (Formatter *self),
   TRACE ("%s:=%s", name.c_str (), strbool (value));
 }
 
+/**
+ * @brief Sets the image cache size option of the given Formatter.
+ * @param self Formatter.
+ * @param name Must be the string "imageCacheSize".
+ * @param value Memory budget of the decoded-image cache in kilobytes.
+ */
+void
+Formatter::setOptionImageCacheSize (unused (Formatter *self),
+                                    const string &name, int value)
+{
+  g_assert (name == "imageCacheSize");
+  PlayerImage::setCacheBudget ((gsize) MAX (value, 0) * 1024);
+  TRACE ("%s:=%d", name.c_str (), value);
+}
+
 /**
  * @brief Sets the OpenGL option of the given Formatter.
  * @param self Formatter.
@@ -574,6 +1136,62 @@ Formatter::setOptionOpenGL (unused (Formatter *self), const string &name,
   TRACE ("%s:=%s", name.c_str (), strbool (value));
 }
 
+/**
+ * @brief Sets the streaming parse option of the given Formatter.
+ * @param self Formatter.
+ * @param name Must be the string "streamingParse".
+ * @param value Streaming parse flag value.
+ */
+void
+Formatter::setOptionStreamingParse (unused (Formatter *self),
+                                    const string &name, bool value)
+{
+  g_assert (name == "streamingParse");
+  TRACE ("%s:=%s", name.c_str (), strbool (value));
+}
+
+/**
+ * @brief Sets the background parse option of the given Formatter.
+ * @param self Formatter.
+ * @param name Must be the string "backgroundParse".
+ * @param value Background parse flag value.
+ */
+void
+Formatter::setOptionBackgroundParse (unused (Formatter *self),
+                                     const string &name, bool value)
+{
+  g_assert (name == "backgroundParse");
+  TRACE ("%s:=%s", name.c_str (), strbool (value));
+}
+
+/**
+ * @brief Sets the video scaling option of the given Formatter.
+ * @param self Formatter.
+ * @param name Must be the string "scaleVideo".
+ * @param value Video scaling flag value.
+ */
+void
+Formatter::setOptionScaleVideo (unused (Formatter *self), const string &name,
+                                bool value)
+{
+  g_assert (name == "scaleVideo");
+  TRACE ("%s:=%s", name.c_str (), strbool (value));
+}
+
+/**
+ * @brief Sets the synchronous image decoding option of the given Formatter.
+ * @param self Formatter.
+ * @param name Must be the string "syncImageDecode".
+ * @param value Synchronous image decoding flag value.
+ */
+void
+Formatter::setOptionSyncImageDecode (unused (Formatter *self),
+                                     const string &name, bool value)
+{
+  g_assert (name == "syncImageDecode");
+  TRACE ("%s:=%s", name.c_str (), strbool (value));
+}
+
 /**
  * @brief Sets the width or height options of the given Formatter.
  * @param self Formatter.
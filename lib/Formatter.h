@@ -30,6 +30,7 @@ class Event;
 class Media;
 class MediaSettings;
 class Object;
+class Player;
 
 /**
  * @brief Interface between libginga and the external world.
@@ -45,9 +46,11 @@ public:
 
   void resize (int, int);
   void redraw (cairo_t *);
+  bool getDamage (cairo_region_t *);
 
   bool sendKey (const std::string &, bool);
   bool sendTick (uint64_t, uint64_t, uint64_t);
+  bool getNextDeadline (uint64_t *, bool *);
 
   const GingaOptions *getOptions ();
   bool getOptionBool (const std::string &);
@@ -62,14 +65,30 @@ public:
   ~Formatter ();
 
   Document *getDocument ();
+  Time getTimeToFirstFrame ();
   bool getEOS ();
   void setEOS (bool);
 
+  const vector<Player *> *getDisplayList ();
+  bool displayListAdd (Player *);
+  bool displayListRemove (Player *);
+  void displayListUpdate (Player *);
+  void damage (const Rect &);
+  void damageAll ();
+
   static void setOptionBackground (Formatter *, const string &, string);
   static void setOptionDebug (Formatter *, const string &, bool);
   static void setOptionExperimental (Formatter *, const string &, bool);
+  static void setOptionImageCacheSize (Formatter *, const string &, int);
   static void setOptionOpenGL (Formatter *, const string &, bool);
   static void setOptionSize (Formatter *, const string &, int);
+  static void setOptionSyncImageDecode (Formatter *, const string &, bool);
+  static void setOptionStreamingParse (Formatter *, const string &, bool);
+  static void setOptionBackgroundParse (Formatter *, const string &, bool);
+  static void setOptionScaleVideo (Formatter *, const string &, bool);
+
+  static void setWakeupCallback (GingaWakeupFunc, void *);
+  static void wakeup ();
 
 private:
   /// @brief Current state.
@@ -101,6 +120,57 @@ private:
 
   /// @brief Whether the presentation has ended naturally.
   bool _eos;
+
+  /// @brief Players that are not sleeping sorted by z-index and z-order.
+  vector<Player *> _displayList;
+
+  /// @brief Index of the player being drawn by Formatter::redraw (or -1).
+  int _displayListCursor;
+
+  /// @brief Number of display list items walked by the last redraw.
+  guint _displayListWalked;
+
+  /// @brief Number of display list items drawn by the last redraw.
+  guint _displayListDrawn;
+
+  /// @brief Area of the screen that should be repainted by next redraw.
+  cairo_region_t *_damage;
+
+  /// @brief Area of the screen covered by the debugging overlay.
+  Rect _debugRect;
+
+  /// @brief Monotonic time at which the current presentation was started.
+  Time _startTime;
+
+  /// @brief Time from start to the first frame that drew something.
+  Time _firstFrameTime;
+
+  /// @brief Data shared with a background parse thread.
+  /// @remark The job is owned jointly by the formatter and the thread;
+  /// whichever drops the last reference frees it.  This way the formatter
+  /// can stop (or be destroyed) without waiting for the thread.
+  typedef struct ParseJob
+  {
+    gint refcount;  // reference count (accessed atomically)
+    gint done;      // whether parsing has finished (accessed atomically)
+    string path;    // document path
+    int width;      // screen width
+    int height;     // screen height
+    bool streaming; // whether to parse in streaming mode
+    Document *doc;  // parsed document (or null)
+    string errmsg;  // error message
+  } ParseJob;
+
+  /// @brief Document being parsed in background mode (or null).
+  ParseJob *_parseJob;
+
+  void collectDamage ();
+  void updateOcclusion ();
+  static Document *parseDocument (const string &, int, int, bool, string *);
+  bool startDocument ();
+  bool attachDocument ();
+  static void parseJobUnref (ParseJob *);
+  static gpointer parseThread (gpointer);
 };
 
 GINGA_NAMESPACE_END
@@ -19,6 +19,7 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 #include "ginga.h"
 #include "aux-ginga.h"
 
+#include "DocumentCache.h"
 #include "Formatter.h"
 
 /**
@@ -54,6 +55,49 @@ Ginga::create (const GingaOptions *opts)
   return new Formatter (opts);
 }
 
+/**
+ * @brief Sets the function that wakes up the host.
+ *
+ * Work done by background threads, such as decoding images, may change
+ * the presentation while the host sleeps until the deadline returned by
+ * Ginga::getNextDeadline().  When such work finishes, \p func is called
+ * so that the host resumes ticking.  The function is called from the
+ * thread that did the work, so it must only schedule the tick, e.g., by
+ * adding an idle source or posting an event to the host main loop.  The
+ * callback is shared by all Ginga objects in the process.
+ *
+ * @param func Wake-up function, or null to disable wake-ups.
+ * @param data User data to pass to \p func.
+ */
+void
+Ginga::setWakeupCallback (GingaWakeupFunc func, void *data)
+{
+  Formatter::setWakeupCallback (func, data);
+}
+
+/**
+ * @brief Precompiles an NCL file.
+ *
+ * Parses the NCL file and saves the resulting document into a binary
+ * cache file next to it.  Ginga::start() loads the document from this
+ * cache file, instead of parsing the NCL file, while the file and the
+ * documents it imports remain unchanged.
+ *
+ * @param path Path to NCL file.
+ * @param opts Options (only the screen size is used).
+ * @param[out] errmsg Variable to store the error message (if any).
+ * @return \c true if successful or \c false otherwise.
+ */
+bool
+Ginga::precompile (const string &path, const GingaOptions *opts,
+                   string *errmsg)
+{
+  g_assert_nonnull (opts);
+  setlocale (LC_ALL, "C");
+  return DocumentCache::precompile (path, opts->width, opts->height,
+                                    errmsg);
+}
+
 /**
  * @brief Gets libginga version string.
  * @return libginga version string.
@@ -94,9 +138,22 @@ Ginga::version ()
 /**
  * @fn Ginga::redraw
  * @brief Draws the latest frame of the presentation on Cairo context.
+ *
+ * Only the part of the screen inside the clip region of \p cr is
+ * repainted.  Hosts that keep the contents of previous frames should clip
+ * \p cr to the area returned by Ginga::getDamage().
+ *
  * @param cr Cairo context.
  */
 
+/**
+ * @fn Ginga::getDamage
+ * @brief Gets the area of the screen that changed since the last redraw.
+ * @param region Cairo region to be extended with the damaged area (can be
+ * null).
+ * @return \c true if the damaged area is not empty, or \c false otherwise.
+ */
+
 /**
  * @fn Ginga::sendKey
  * @brief Sends key event to presentation.
@@ -114,6 +171,23 @@ Ginga::version ()
  * @return \c true if successful, or \c false otherwise.
  */
 
+/**
+ * @fn Ginga::getNextDeadline
+ * @brief Gets the time until the presentation needs the next tick.
+ *
+ * Hosts can use this to sleep between ticks instead of polling: while
+ * nothing is scheduled, the presentation only changes in response to keys
+ * and there is no need to call Ginga::sendTick() before the next key is
+ * sent.  A delay of zero means that the presentation should be ticked on
+ * every frame, e.g., while an animation or a video is playing.
+ *
+ * @param[out] delay Variable to store the time until the next tick is
+ * needed (can be null).
+ * @param[out] redraw Variable to store whether the screen should be
+ * redrawn, i.e., whether the damaged area is not empty (can be null).
+ * @return \c true if something is scheduled, or \c false otherwise.
+ */
+
 /**
  * @fn Ginga::getOptions
  * @brief Gets current options.
@@ -26,6 +26,13 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
+// Orders delayed actions by scheduling order.
+static bool
+delayed_action_seq_cmp (const DelayedAction &a, const DelayedAction &b)
+{
+  return a.seq < b.seq;
+}
+
 // Public.
 
 Media::Media (const string &id) : Object (id)
@@ -165,6 +172,24 @@ Media::sendTick (Time total, Time diff, Time frame)
     }
 }
 
+Time
+Media::getTimeToNextDeadline ()
+{
+  Time next, dur;
+
+  next = Object::getTimeToNextDeadline ();
+  if (!this->isOccurring () || _player == nullptr)
+    return next;
+
+  // The next tick detects the end of the media object.
+  if (_player->getEOS ())
+    return 0;
+  if (GINGA_TIME_IS_VALID (dur = _player->getDuration ()))
+    next = MIN (next, (dur >= _time) ? dur - _time + 1 : 0);
+
+  return MIN (next, _player->getTimeToNextDeadline ());
+}
+
 bool
 Media::beforeTransition (Event *evt, Event::Transition transition)
 {
@@ -240,29 +265,28 @@ Media::beforeTransition (Event *evt, Event::Transition transition)
                            GINGA_TIME_ARGS (begin), GINGA_TIME_ARGS (end),
                            GINGA_TIME_ARGS (_time));
 
-                    // remove events of anchors that happens before or after
-                    // anchor started.
-                    for (auto it = _delayed.begin ();
-                         it != _delayed.end ();)
+                    // Remove the delayed actions that fall outside the
+                    // anchor interval and rebase the remaining ones on the
+                    // anchor begin.  The START actions that precede the
+                    // anchor are triggered right away.
+                    vector<DelayedAction> delayed;
+                    delayed.swap (_delayed);
+                    std::sort (delayed.begin (), delayed.end (),
+                               delayed_action_seq_cmp);
+                    for (auto &it : delayed)
                       {
-                        if (it->second == GINGA_TIME_NONE
-                            || it->second < begin
-                            || (end != GINGA_TIME_NONE && it->second > end))
+                        if (it.time < begin
+                            || (end != GINGA_TIME_NONE && it.time > end))
                           {
-                            Action act = it->first;
-                            Event *evt = act.event;
-                            if (act.transition == Event::START
-                                && it->second < begin)
-                              evt->transition (act.transition);
-                            it = _delayed.erase (it);
+                            if (it.action.transition == Event::START
+                                && it.time < begin)
+                              it.action.event->transition (Event::START);
                           }
-                        else if (it->second >= begin)
+                        else
                           {
-                            it->second = it->second - begin;
-                            ++it;
+                            it.time -= begin;
+                            this->pushDelayedAction (it);
                           }
-                        else
-                          ++it;
                       }
                   }
               }
@@ -403,30 +427,22 @@ Media::afterTransition (Event *evt, Event::Transition transition)
     case Event::ATTRIBUTION:
       {
         string value;
-        evt->getParameter ("value", &value);
+        value = evt->getAttributionValue ();
         switch (transition)
           {
           case Event::START:
             {
               string name;
-              string s;
               Time dur;
 
               name = evt->getId ();
-              _doc->evalPropertyRef (value, &value);
-
-              dur = 0;
-              if (evt->getParameter ("duration", &s))
-                {
-                  _doc->evalPropertyRef (s, &s);
-                  dur = ginga::parse_time (s);
-                }
+              dur = evt->getAttributionDuration ();
               this->setProperty (name, value, dur);
               this->addDelayedAction (evt, Event::STOP, value, dur);
-              TRACE ("start %s:='%s' (dur=%s) at %" GINGA_TIME_FORMAT,
+              TRACE ("start %s:='%s' (dur=%" GINGA_TIME_FORMAT
+                     ") at %" GINGA_TIME_FORMAT,
                      evt->getFullId ().c_str (), value.c_str (),
-                     (s != "") ? s.c_str () : "0s",
-                     GINGA_TIME_ARGS (_time));
+                     GINGA_TIME_ARGS (dur), GINGA_TIME_ARGS (_time));
               break;
             }
 
@@ -491,6 +507,7 @@ Media::redraw (cairo_t *cr)
 {
   if (this->isSleeping () || _player == nullptr)
     return; // nothing to do
+  _player->update ();
   _player->redraw (cr);
 }
 
@@ -64,6 +64,14 @@ MediaSettings::sendTick (Time total, Time diff, Time frame)
   Media::sendTick (total, diff, frame);
 }
 
+Time
+MediaSettings::getTimeToNextDeadline ()
+{
+  if (_hasNextFocus && this->isOccurring ())
+    return 0; // focus is updated by the next tick
+  return Media::getTimeToNextDeadline ();
+}
+
 // Public: Media.
 
 bool
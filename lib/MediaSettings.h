@@ -32,6 +32,7 @@ public:
   string getObjectTypeAsString () override;
   void setProperty (const string &, const string &, Time) override;
   void sendTick (Time, Time, Time) override;
+  Time getTimeToNextDeadline () override;
 
   // Media;
   bool isFocused () override;
@@ -28,6 +28,17 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
+// Heap order of delayed actions.  The standard heap functions keep the
+// greatest element at the front, so this returns true if \p a is due after
+// \p b; actions due at the same time are ordered by scheduling order.
+static bool
+delayed_action_due_after (const DelayedAction &a, const DelayedAction &b)
+{
+  if (a.time != b.time)
+    return a.time > b.time;
+  return a.seq > b.seq;
+}
+
 // Public.
 
 Object::Object (const string &id) : _id (id)
@@ -35,6 +46,9 @@ Object::Object (const string &id) : _id (id)
   _doc = nullptr;
   _parent = nullptr;
   _time = GINGA_TIME_NONE;
+  _delayedSeq = 0;
+  for (auto &link : _links)
+    link = { nullptr, nullptr, 0, false };
 
   this->addPresentationEvent ("@lambda", 0, GINGA_TIME_NONE);
   _lambda = this->getPresentationEvent ("@lambda");
@@ -43,6 +57,8 @@ Object::Object (const string &id) : _id (id)
 
 Object::~Object ()
 {
+  if (_doc != nullptr)
+    _doc->removeActiveObject (this);
   for (auto evt : _events)
     delete evt;
 }
@@ -183,8 +199,13 @@ void
 Object::addAlias (const string &alias, Composition *parent)
 {
   auto alias_pair = make_pair (alias, parent);
-  // _aliases.push_back (alias_pair);
-  tryinsert (alias_pair, _aliases, push_back);
+  if (!(tryinsert (alias_pair, _aliases, push_back)))
+    return;
+
+  if (_parent != nullptr)
+    _parent->addChildAlias (this, alias);
+  if (_doc != nullptr)
+    _doc->addObjectAlias (this, alias);
 }
 
 const set<Event *> *
@@ -306,6 +327,12 @@ Object::isSleeping ()
   return _lambda->getState () == Event::SLEEPING;
 }
 
+const map<string, string> *
+Object::getProperties ()
+{
+  return &_properties;
+}
+
 string
 Object::getProperty (const string &name)
 {
@@ -319,10 +346,56 @@ void
 Object::setProperty (const string &name, const string &value, Time dur)
 {
   g_assert (GINGA_TIME_IS_VALID (dur));
-  _properties[name] = value;
+
+  if (likely (_watchers.empty ()))
+    {
+      _properties[name] = value;
+      return;
+    }
+
+  string &slot = _properties[name];
+  if (slot == value)
+    return;
+
+  slot = value;
+  auto it = _watchers.find (name);
+  if (it != _watchers.end ())
+    for (auto watcher : it->second)
+      watcher->propertyChanged (this, name);
+}
+
+/**
+ * @brief Adds property watcher.
+ *
+ * The watcher's propertyChanged() is called whenever the value of property
+ * \p name of this object changes.
+ *
+ * @param name Property name.
+ * @param watcher The watcher object.
+ */
+void
+Object::addPropertyWatcher (const string &name, Object *watcher)
+{
+  g_assert_nonnull (watcher);
+  _watchers[name].insert (watcher);
+}
+
+/**
+ * @brief Signals that a watched property has changed.
+ *
+ * This function is called by the object \p obj after the value of its
+ * property \p name has changed, if this object was added as a watcher of
+ * that property.  The default implementation does nothing.
+ *
+ * @param obj The object whose property has changed.
+ * @param name Property name.
+ */
+void
+Object::propertyChanged (unused (Object *obj), unused (const string &name))
+{
 }
 
-const list<pair<Action, Time> > *
+const vector<DelayedAction> *
 Object::getDelayedActions ()
 {
   return &_delayed;
@@ -332,12 +405,41 @@ void
 Object::addDelayedAction (Event *event, Event::Transition transition,
                           const string &value, Time delay)
 {
-  Action act;
+  DelayedAction delayed;
 
-  act.event = event;
-  act.transition = transition;
-  act.value = value;
-  _delayed.push_back (std::make_pair (act, _time + delay));
+  delayed.action.event = event;
+  delayed.action.transition = transition;
+  delayed.action.predicate = nullptr;
+  delayed.action.value = value;
+  delayed.action.valueParam.compiled = true; // already evaluated
+  delayed.action.durationParam.compiled = true;
+  delayed.action.durationParam.time = 0;
+  delayed.time = _time + delay;
+  this->pushDelayedAction (delayed);
+}
+
+Time
+Object::getNextDeadline ()
+{
+  if (_delayed.empty ())
+    return GINGA_TIME_NONE;
+  return _delayed.front ().time;
+}
+
+Time
+Object::getTimeToNextDeadline ()
+{
+  Time deadline;
+
+  if (!this->isOccurring ())
+    return GINGA_TIME_NONE;
+
+  deadline = this->getNextDeadline ();
+  if (!GINGA_TIME_IS_VALID (deadline))
+    return GINGA_TIME_NONE;
+
+  g_assert (GINGA_TIME_IS_VALID (_time));
+  return (deadline > _time) ? deadline - _time : 0;
 }
 
 void
@@ -348,36 +450,27 @@ Object::sendKey (unused (const string &key), unused (bool press))
 void
 Object::sendTick (unused (Time total), Time diff, unused (Time frame))
 {
+  guint64 last;
+
   if (unlikely (!this->isOccurring ()))
     return; // nothing to do
 
   g_assert (GINGA_TIME_IS_VALID (_time));
   _time += diff;
 
-  list<Action> trigger;
-  for (auto &it : _delayed)
-    {
-      if (_time >= it.second)
-        {
-          it.second = GINGA_TIME_NONE;
-          trigger.push_back (it.first);
-        }
-    }
-
-  for (auto action : trigger)
+  // Trigger the actions that are due, in order.  Actions scheduled while
+  // this is done get a greater sequence number and are left to the next
+  // tick, even if they are already due.
+  last = _delayedSeq;
+  while (!_delayed.empty () && _delayed.front ().time <= _time
+         && _delayed.front ().seq <= last)
     {
-      _doc->evalAction (action);
+      Action act = _delayed.front ().action;
+      this->popDelayedAction ();
+      _doc->evalAction (act);
       if (!this->isOccurring ())
         return;
     }
-
-  for (auto it = _delayed.begin (); it != _delayed.end ();)
-    {
-      if (it->second == GINGA_TIME_NONE)
-        it = _delayed.erase (it);
-      else
-        ++it;
-    }
 }
 
 Time
@@ -411,4 +504,22 @@ Object::doStop ()
     cast (Context *, _parent)->decAwakeChildren ();
 }
 
+void
+Object::pushDelayedAction (const DelayedAction &delayed)
+{
+  _delayed.push_back (delayed);
+  _delayed.back ().seq = ++_delayedSeq;
+  std::push_heap (_delayed.begin (), _delayed.end (),
+                  delayed_action_due_after);
+}
+
+void
+Object::popDelayedAction ()
+{
+  g_assert_false (_delayed.empty ());
+  std::pop_heap (_delayed.begin (), _delayed.end (),
+                 delayed_action_due_after);
+  _delayed.pop_back ();
+}
+
 GINGA_NAMESPACE_END
@@ -25,9 +25,33 @@ GINGA_NAMESPACE_BEGIN
 class Document;
 class Composition;
 class MediaSettings;
+class ObjectList;
+
+/**
+ * @brief Link of an object in an intrusive #ObjectList.
+ */
+typedef struct ObjectListLink
+{
+  Object *prev;  ///< Previous object in list.
+  Object *next;  ///< Next object in list.
+  guint64 stamp; ///< Insertion stamp.
+  bool linked;   ///< Whether object is in list.
+} ObjectListLink;
+
+/**
+ * @brief Action scheduled to be triggered at a given object time.
+ */
+typedef struct DelayedAction
+{
+  Action action; ///< Action to be triggered.
+  Time time;     ///< Object time at which the action is due.
+  guint64 seq;   ///< Scheduling order (breaks ties between equal times).
+} DelayedAction;
 
 class Object
 {
+  friend class ObjectList;
+
 public:
   explicit Object (const string &);
   virtual ~Object ();
@@ -63,12 +87,17 @@ public:
   bool isPaused ();
   bool isSleeping ();
 
+  const map<string, string> *getProperties ();
   virtual string getProperty (const string &);
   virtual void setProperty (const string &, const string &, Time dur = 0);
+  void addPropertyWatcher (const string &, Object *);
+  virtual void propertyChanged (Object *, const string &);
 
-  const list<pair<Action, Time> > *getDelayedActions ();
+  const vector<DelayedAction> *getDelayedActions ();
   void addDelayedAction (Event *, Event::Transition,
                          const string &value = "", Time delay = 0);
+  Time getNextDeadline ();
+  virtual Time getTimeToNextDeadline ();
 
   virtual void sendKey (const string &, bool);
   virtual void sendTick (Time, Time, Time);
@@ -112,12 +141,18 @@ protected:
   list<pair<string, Composition *> > _aliases; // aliases
   Time _time;                                  // playback time
   map<string, string> _properties;             // property map
+  map<string, set<Object *> > _watchers;       // property watchers
   Event *_lambda;                              // lambda event
   set<Event *> _events;                        // all events
-  list<pair<Action, Time> > _delayed;          // delayed actions
+  vector<DelayedAction> _delayed;              // delayed actions (heap)
+  guint64 _delayedSeq;                         // last scheduling order
+  ObjectListLink _links[2];                    // links in active lists
 
   virtual void doStart ();
   virtual void doStop ();
+
+  void pushDelayedAction (const DelayedAction &);
+  void popDelayedAction ();
 };
 
 GINGA_NAMESPACE_END
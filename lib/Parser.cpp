@@ -27,6 +27,7 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 #include <libxml/tree.h>
 #include <libxml/parser.h>
 #include <libxml/uri.h>
+#include <libxml/xmlreader.h>
 
 GINGA_NAMESPACE_BEGIN
 
@@ -38,6 +39,15 @@ GINGA_NAMESPACE_BEGIN
 /// Flags to LibXML parser.
 #define PARSER_LIBXML_FLAGS (XML_PARSE_NOERROR | XML_PARSE_NOWARNING)
 
+/// Flags to LibXML reader (used by streaming mode).
+#define PARSER_LIBXML_READER_FLAGS (PARSER_LIBXML_FLAGS | XML_PARSE_NOBLANKS)
+
+/// Maximum number of imported documents kept in the import cache.
+#define PARSER_IMPORT_CACHE_SIZE 32
+
+/// Current monotonic time (used by parser timing counters).
+#define PARSER_NOW() ((Time) g_get_monotonic_time () * GINGA_USECOND)
+
 /// Gets last XML error as C++ string.
 static inline string
 xmlGetLastErrorAsString ()
@@ -174,6 +184,18 @@ typedef struct ParserLinkBind
   map<string, string> params; ///< Bind parameters.
 } ParserLinkBind;
 
+/**
+ * @brief Reader frame.
+ *
+ * Open element while the document is being processed in streaming mode.
+ */
+typedef struct ParserReaderFrame
+{
+  ParserElt *elt;          ///< Element wrapper.
+  ParserSyntaxElt *eltsyn; ///< Element syntax.
+  bool cached;             ///< Whether element is in element cache.
+} ParserReaderFrame;
+
 /**
  * @brief Parser state.
  *
@@ -202,7 +224,9 @@ public:
   ParserState (int, int);
   ~ParserState ();
   ParserState::Error getError (string *);
+  const ParserStats *getStats ();
   Document *process (xmlDoc *);
+  Document *processReader (xmlTextReader *);
 
   // push & pop
   static bool pushNcl (ParserState *, ParserElt *);
@@ -239,6 +263,7 @@ public:
 private:
   Document *_doc;      ///< The resulting #Document.
   xmlDoc *_xml;        ///< The DOM tree being processed.
+  xmlDoc *_skel;       ///< Element skeleton (streaming mode).
   int _genid;          ///< Last generated id.
   UserData _udata;     ///< Attached user data.
   set<string> _unique; ///< Unique attributes seen so far.
@@ -246,9 +271,14 @@ private:
   ParserState::Error _error; ///< Last error code.
   string _errorMsg;          ///< Last error message.
 
+  ParserStats _stats; ///< Timing counters.
+
   map<xmlNode *, ParserElt *> _eltCache;          ///< Element cache.
   map<string, list<ParserElt *> > _eltCacheByTag; ///< Element cache by tag.
 
+  /// Element cache by tag and id.
+  map<string, unordered_map<string, ParserElt *> > _eltCacheById;
+
   /// Alias stack for solving imports.
   list<pair<string, string> > _aliasStack;
 
@@ -261,6 +291,9 @@ private:
   ///< Reference map for solving the refer attribute in \<media\>.
   map<string, Media *> _referMap;
 
+  ///< Shared imported documents processed so far.
+  set<xmlDoc *> _importDocs;
+
   string genId ();
   string getURI ();
   bool isInUniqueSet (const string &);
@@ -327,6 +360,10 @@ private:
   ParserSyntaxElt *checkNode (xmlNode *, map<string, string> *,
                               list<xmlNode *> *);
   bool processNode (xmlNode *);
+  void prefetchImports (xmlNode *);
+  void prefetchHeadImports (xmlNode *);
+  bool processReaderStart (xmlNode *, list<ParserReaderFrame> *);
+  bool processReaderEnd (list<ParserReaderFrame> *);
 };
 
 /// Asserted version of UserData::getData().
@@ -1377,20 +1414,16 @@ bool
 ParserState::eltCacheIndexById (const string &id, ParserElt **elt,
                                 const list<string> &tags)
 {
-  for (auto tag : tags)
+  for (auto &tag : tags)
     {
-      auto it = _eltCacheByTag.find (tag);
-      if (it == _eltCacheByTag.end ())
+      auto it = _eltCacheById.find (tag);
+      if (it == _eltCacheById.end ())
         continue;
-      for (auto other : it->second)
-        {
-          string other_id;
-          if (other->getAttribute ("id", &other_id) && other_id == id)
-            {
-              tryset (elt, other);
-              return true;
-            }
-        }
+      auto it_id = it->second.find (id);
+      if (it_id == it->second.end ())
+        continue;
+      tryset (elt, it_id->second);
+      return true;
     }
   return false;
 }
@@ -1436,6 +1469,13 @@ ParserState::eltCacheAdd (ParserElt *elt)
     return false;
   _eltCache[node] = elt;
   _eltCacheByTag[elt->getTag ()].push_back (elt);
+
+  // If there are elements with the same tag and id, the first one wins.
+  string id;
+  if (elt->getAttribute ("id", &id))
+    _eltCacheById[elt->getTag ()].insert (std::make_pair (id, elt));
+
+  _stats.cached++;
   return true;
 }
 
@@ -2147,6 +2187,7 @@ ParserState::processNode (xmlNode *node)
     return false;
 
   // Allocate and initialize element wrapper.
+  _stats.elements++;
   elt = new ParserElt (node);
   for (auto it : attrs)
     g_assert (elt->setAttribute (it.first, it.second));
@@ -2192,6 +2233,114 @@ done:
   return status;
 }
 
+/**
+ * @brief Starts the processing of node in streaming mode.
+ *
+ * Called by ParserState::processReader() when the reader enters an
+ * element.  Does the same as the first half of ParserState::processNode(),
+ * except that \p node has no children yet; these are checked against the
+ * parent (the top of \p stack) as they are read.
+ *
+ * The reader frees \p node once it moves past its subtree, so the element
+ * wrapper does not point to \p node but to a copy of it in the skeleton
+ * tree.  The copy keeps only the tag, the line number and the parent link,
+ * which is all that error reporting and the element cache need; the
+ * attributes were already copied into the wrapper by
+ * ParserState::checkNode().
+ *
+ * @param node The node to process.
+ * @param stack The stack of open elements.
+ * @return \c true if successful, or \c false otherwise.
+ */
+bool
+ParserState::processReaderStart (xmlNode *node,
+                                 list<ParserReaderFrame> *stack)
+{
+  map<string, string> attrs;
+  ParserReaderFrame frame;
+  xmlNode *skel;
+
+  // Check if node is a possible child of its parent.
+  if (stack->size () > 0)
+    {
+      string tag = toCPPString (node->name);
+      string parent = stack->back ().elt->getTag ();
+      map<string, bool> possible
+          = parser_syntax_table_get_possible_children (parent);
+      if (unlikely (possible.find (tag) == possible.end ()))
+        return this->errEltUnknownChild (node->parent, tag);
+    }
+
+  // Check node.
+  frame.eltsyn = this->checkNode (node, &attrs, nullptr);
+  if (unlikely (frame.eltsyn == nullptr))
+    return false;
+
+  // Copy node into skeleton tree.
+  skel = xmlNewDocNodeEatName (
+      _skel, nullptr, (xmlChar *) xmlDictLookup (_skel->dict, node->name, -1),
+      nullptr);
+  g_assert_nonnull (skel);
+  skel->line = node->line;
+  if (stack->size () > 0)
+    g_assert_nonnull (xmlAddChild (stack->back ().elt->getNode (), skel));
+  else
+    xmlDocSetRootElement (_skel, skel);
+
+  // Allocate and initialize element wrapper.
+  _stats.elements++;
+  frame.elt = new ParserElt (skel);
+  frame.cached = false;
+  for (auto it : attrs)
+    g_assert (frame.elt->setAttribute (it.first, it.second));
+
+  // Push element.
+  if (unlikely (frame.eltsyn->push != nullptr
+                && !frame.eltsyn->push (this, frame.elt)))
+    {
+      delete frame.elt;
+      return false;
+    }
+
+  // Save element into cache.
+  if (frame.eltsyn->flags & ELT_CACHE)
+    {
+      frame.cached = true;
+      g_assert (this->eltCacheAdd (frame.elt));
+    }
+
+  stack->push_back (frame);
+  return true;
+}
+
+/**
+ * @brief Ends the processing of node in streaming mode.
+ *
+ * Called by ParserState::processReader() when the reader leaves an
+ * element.  Pops the top of \p stack and calls the corresponding pop
+ * function (if any).
+ *
+ * @param stack The stack of open elements.
+ * @return \c true if successful, or \c false otherwise.
+ */
+bool
+ParserState::processReaderEnd (list<ParserReaderFrame> *stack)
+{
+  ParserReaderFrame frame;
+  bool status;
+
+  g_assert (stack->size () > 0);
+  frame = stack->back ();
+  stack->pop_back ();
+
+  status = frame.eltsyn->pop == nullptr
+           || frame.eltsyn->pop (this, frame.elt);
+
+  if (!frame.cached)
+    delete frame.elt;
+  return status;
+}
+
 // ParserState: public.
 
 /**
@@ -2204,9 +2353,11 @@ ParserState::ParserState (int width, int height)
 {
   _doc = nullptr;
   _xml = nullptr;
+  _skel = nullptr;
   g_assert_cmpint (width, >, 0);
   g_assert_cmpint (height, >, 0);
   _genid = 0;
+  _stats = { 0, 0, 0, 0, 0, 0 };
   _error = ParserState::ERROR_NONE;
   _errorMsg = "no error";
   this->rectStackPush ({ 0, 0, width, height });
@@ -2219,6 +2370,8 @@ ParserState::~ParserState ()
 {
   for (auto it : _eltCache)
     delete it.second;
+  if (_skel != nullptr)
+    xmlFreeDoc (_skel);
 }
 
 /**
@@ -2233,6 +2386,20 @@ ParserState::getError (string *message)
   return _error;
 }
 
+/**
+ * @brief Gets timing counters.
+ *
+ * The #ParserStats::read counter includes only imported documents, and
+ * #ParserStats::total is not set; these are up to the caller of process().
+ *
+ * @return The timing counters of last call to process().
+ */
+const ParserStats *
+ParserState::getStats ()
+{
+  return &_stats;
+}
+
 /**
  * @brief Processes XML document.
  *
@@ -2247,6 +2414,8 @@ Document *
 ParserState::process (xmlDoc *xml)
 {
   xmlNode *root;
+  Time t0;
+  bool status;
 
   g_assert_nonnull (xml);
   _xml = xml;
@@ -2255,7 +2424,95 @@ ParserState::process (xmlDoc *xml)
   root = xmlDocGetRootElement (xml);
   g_assert_nonnull (root);
 
-  if (unlikely (!this->processNode (root)))
+  t0 = PARSER_NOW ();
+  this->prefetchImports (root);
+  status = this->processNode (root);
+  _stats.process = PARSER_NOW () - t0 - _stats.read - _stats.resolve;
+
+  if (unlikely (!status))
+    {
+      delete _doc;
+      _doc = nullptr;
+      return nullptr;
+    }
+
+  g_assert_nonnull (_doc);
+  return _doc;
+}
+
+/**
+ * @brief Processes XML document in streaming mode.
+ *
+ * This function does the same as ParserState::process(), but instead of
+ * walking a complete DOM tree it consumes the document as it is read from
+ * \p reader, calling the push and pop functions as elements are opened and
+ * closed.  Forward references are resolved at the end, by the pop function
+ * of \<ncl\>, as in the DOM mode.
+ *
+ * No node is preserved: the reader frees each subtree as soon as it is
+ * consumed, and only the element skeleton built by
+ * ParserState::processReaderStart() is kept until the state is destroyed.
+ *
+ * If \p reader fails, the function returns null without setting #Parser
+ * error; in this case, the error is in the last LibXML error.
+ *
+ * @param reader The XML reader to consume.
+ * @return The resulting #Document if successful, or null otherwise.
+ */
+Document *
+ParserState::processReader (xmlTextReader *reader)
+{
+  list<ParserReaderFrame> stack;
+  Time t0;
+  bool status;
+  int ret;
+
+  g_assert_nonnull (reader);
+  _doc = new Document ();
+  _skel = xmlNewDoc ((const xmlChar *) "1.0");
+  g_assert_nonnull (_skel);
+  _skel->dict = xmlDictCreate ();
+  g_assert_nonnull (_skel->dict);
+
+  t0 = PARSER_NOW ();
+  status = true;
+  ret = 0;
+  while (status && (ret = xmlTextReaderRead (reader)) == 1)
+    {
+      xmlNode *node;
+
+      switch (xmlTextReaderNodeType (reader))
+        {
+        case XML_READER_TYPE_ELEMENT:
+          node = xmlTextReaderCurrentNode (reader);
+          g_assert_nonnull (node);
+          if (_xml == nullptr)
+            _xml = node->doc;
+          // Read the whole head at once, so that the documents it imports
+          // are read concurrently, as in DOM mode.
+          if (xmlStrEqual (node->name, (const xmlChar *) "head")
+              && (node = xmlTextReaderExpand (reader)) != nullptr)
+            this->prefetchHeadImports (node);
+          node = xmlTextReaderCurrentNode (reader);
+          if (!(status = this->processReaderStart (node, &stack)))
+            break;
+          if (xmlTextReaderIsEmptyElement (reader))
+            status = this->processReaderEnd (&stack);
+          break;
+        case XML_READER_TYPE_END_ELEMENT:
+          status = this->processReaderEnd (&stack);
+          break;
+        default:
+          break;
+        }
+    }
+  _stats.process = PARSER_NOW () - t0 - _stats.read - _stats.resolve;
+
+  for (auto frame : stack)
+    if (!frame.cached)
+      delete frame.elt;
+
+  if (unlikely (!status || ret != 0 || _xml == nullptr))
     {
       delete _doc;
       _doc = nullptr;
@@ -2306,6 +2563,9 @@ ParserState::popNcl (ParserState *st, unused (ParserElt *elt))
   list<ParserElt *> media_list;
   list<ParserElt *> switch_list;
   list<ParserElt *> link_list;
+  Time t0;
+
+  t0 = PARSER_NOW ();
 
   // Resolve descriptor references to region/transition.
   // (I.e., move region/transition attributes to associated descriptor.)
@@ -2788,6 +3048,10 @@ borderColor='%s'}",
                     }
                 }
 
+              // Every object exists by now, so property references in
+              // action parameters can be resolved once and for all.
+              st->_doc->compileAction (&act);
+
               if (role->condition)
                 conditions.push_back (act);
               else
@@ -2798,6 +3062,7 @@ borderColor='%s'}",
     }
 
   g_assert_nonnull (st->objStackPop ());
+  st->_stats.resolve += PARSER_NOW () - t0;
   return true;
 }
 
@@ -3387,6 +3652,286 @@ ParserState::pushRule (ParserState *st, ParserElt *elt)
   return true;
 }
 
+// Imported documents.
+
+/**
+ * @brief Imported document.
+ *
+ * Imported documents are read by a pool of worker threads and kept in a
+ * process-wide cache indexed by URI, so that documents importing the same
+ * bases (e.g., a common connector base) read and parse them only once.
+ * Entries are reference counted; the cache holds one reference to each
+ * entry and each user holds another.  The cache keeps at most
+ * #PARSER_IMPORT_CACHE_SIZE entries, dropping the least recently used
+ * first, and is emptied by Parser::clearImportCache().  All fields but
+ * #ParserImport::uri are protected by #parser_import_mutex.
+ */
+typedef struct ParserImport
+{
+  string uri;     ///< Document URI.
+  gint64 mtime;   ///< Modification time (in microseconds) when read.
+  goffset size;   ///< Size (in bytes) when read.
+  xmlDoc *xml;    ///< Parsed document, or null if reading failed.
+  string errmsg;  ///< Error message (if reading failed).
+  bool done;      ///< Whether reading has finished.
+  int refs;       ///< Reference count.
+  guint64 used;   ///< Value of #parser_import_clock when last fetched.
+} ParserImport;
+
+/// Mutex protecting the import cache.
+static GMutex parser_import_mutex;
+
+/// Signaled when an imported document finishes reading.
+static GCond parser_import_cond;
+
+/// Import cache.
+static map<string, ParserImport *> parser_import_cache;
+
+/// Number of cache lookups so far (orders cache entries by last use).
+static guint64 parser_import_clock = 0;
+
+/// Pool of worker threads that read imported documents.
+static GThreadPool *parser_import_pool = nullptr;
+
+/// Resolves \p uri of imported document relative to \p main_uri.
+static string
+parser_import_resolve_uri (const string &uri, const string &main_uri)
+{
+  string result = uri;
+  if (!xpathisabs (result) && main_uri != "")
+    {
+      result = xpathbuild (xpathdirname (xpathfromuri (main_uri)), result);
+    }
+  return xurifromsrc (result, "");
+}
+
+/// Gets modification time and size of document at \p uri.
+static bool
+parser_import_stat (const string &uri, gint64 *mtime, goffset *size)
+{
+  GFile *file;
+  GFileInfo *info;
+
+  file = g_file_new_for_uri (uri.c_str ());
+  g_assert_nonnull (file);
+  info = g_file_query_info (file,
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED ","
+                            G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC ","
+                            G_FILE_ATTRIBUTE_STANDARD_SIZE,
+                            G_FILE_QUERY_INFO_NONE, nullptr, nullptr);
+  g_object_unref (file);
+  if (info == nullptr)
+    return false;
+
+  *mtime = (gint64) g_file_info_get_attribute_uint64 (
+               info, G_FILE_ATTRIBUTE_TIME_MODIFIED)
+               * G_USEC_PER_SEC
+           + g_file_info_get_attribute_uint32 (
+                 info, G_FILE_ATTRIBUTE_TIME_MODIFIED_USEC);
+  *size = g_file_info_get_size (info);
+  g_object_unref (info);
+  return true;
+}
+
+/// Drops a reference to imported document (mutex must be locked).
+static void
+parser_import_unref_unlocked (ParserImport *imp)
+{
+  g_assert_cmpint (imp->refs, >, 0);
+  if (--imp->refs > 0)
+    return;
+  if (imp->xml != nullptr)
+    xmlFreeDoc (imp->xml);
+  delete imp;
+}
+
+/// Drops the least recently used entries of the import cache until it has
+/// at most \p max entries (mutex must be locked).
+static void
+parser_import_trim_unlocked (size_t max)
+{
+  while (parser_import_cache.size () > max)
+    {
+      auto lru = parser_import_cache.begin ();
+      for (auto it = lru; it != parser_import_cache.end (); ++it)
+        if (it->second->used < lru->second->used)
+          lru = it;
+      ParserImport *imp = lru->second;
+      parser_import_cache.erase (lru);
+      parser_import_unref_unlocked (imp);
+    }
+}
+
+/// Drops a reference to imported document.
+static void
+parser_import_unref (void *ptr)
+{
+  g_mutex_lock (&parser_import_mutex);
+  parser_import_unref_unlocked ((ParserImport *) ptr);
+  g_mutex_unlock (&parser_import_mutex);
+}
+
+/// Reads imported document.
+static void
+parser_import_read (ParserImport *imp)
+{
+  xmlDoc *xml;
+  string errmsg;
+
+  xml = xmlReadFile (imp->uri.c_str (), nullptr, PARSER_LIBXML_FLAGS);
+  if (unlikely (xml == nullptr))
+    errmsg = xmlGetLastErrorAsString ();
+
+  g_mutex_lock (&parser_import_mutex);
+  imp->xml = xml;
+  imp->errmsg = errmsg;
+  imp->done = true;
+  g_cond_broadcast (&parser_import_cond);
+  parser_import_unref_unlocked (imp);
+  g_mutex_unlock (&parser_import_mutex);
+}
+
+/// Reads imported document in a worker thread.
+static void
+parser_import_worker (gpointer data, unused (gpointer user_data))
+{
+  parser_import_read ((ParserImport *) data);
+}
+
+/**
+ * @brief Gets imported document from cache, starting to read it if needed.
+ *
+ * If the cache has no entry for \p uri, or if the document at \p uri has
+ * changed since its entry was read, or if reading it failed, starts
+ * reading it again: in a worker thread if \p async is true, or in the
+ * calling thread otherwise.
+ *
+ * @param uri Document URI.
+ * @param async Whether to read the document in a worker thread.
+ * @return Imported document; the caller owns a reference to it.
+ */
+static ParserImport *
+parser_import_fetch (const string &uri, bool async)
+{
+  ParserImport *imp;
+  gint64 mtime;
+  goffset size;
+  bool cacheable;
+
+  cacheable = parser_import_stat (uri, &mtime, &size);
+
+  g_mutex_lock (&parser_import_mutex);
+  parser_import_clock++;
+  if (cacheable)
+    {
+      auto it = parser_import_cache.find (uri);
+      if (it != parser_import_cache.end ())
+        {
+          imp = it->second;
+          if (imp->mtime == mtime && imp->size == size
+              && (!imp->done || imp->xml != nullptr))
+            {
+              imp->used = parser_import_clock;
+              imp->refs++;
+              g_mutex_unlock (&parser_import_mutex);
+              return imp;
+            }
+          parser_import_cache.erase (it);
+          parser_import_unref_unlocked (imp);
+        }
+    }
+
+  imp = new ParserImport ();
+  imp->uri = uri;
+  imp->mtime = cacheable ? mtime : 0;
+  imp->size = cacheable ? size : 0;
+  imp->xml = nullptr;
+  imp->done = false;
+  imp->refs = 2; // caller and reader
+  imp->used = parser_import_clock;
+  if (cacheable)
+    {
+      parser_import_trim_unlocked (PARSER_IMPORT_CACHE_SIZE - 1);
+      parser_import_cache[uri] = imp;
+      imp->refs++;
+    }
+
+  if (async && parser_import_pool == nullptr)
+    {
+      xmlInitParser ();
+      parser_import_pool = g_thread_pool_new (
+          parser_import_worker, nullptr, (gint) g_get_num_processors (),
+          FALSE, nullptr);
+      g_assert_nonnull (parser_import_pool);
+    }
+  g_mutex_unlock (&parser_import_mutex);
+
+  if (async)
+    g_thread_pool_push (parser_import_pool, imp, nullptr);
+  else
+    parser_import_read (imp);
+
+  return imp;
+}
+
+/// Waits until imported document finishes reading.
+static void
+parser_import_wait (ParserImport *imp)
+{
+  g_mutex_lock (&parser_import_mutex);
+  while (!imp->done)
+    g_cond_wait (&parser_import_cond, &parser_import_mutex);
+  g_mutex_unlock (&parser_import_mutex);
+}
+
+/**
+ * @brief Starts reading the documents imported by the document at \p root.
+ *
+ * Called by ParserState::process() before processing the document, so
+ * that the imported documents are read concurrently, while the main
+ * document is being processed.  Only the imports in the document itself
+ * are prefetched; nested imports are read when they are processed.
+ *
+ * @param root Root node of document.
+ */
+void
+ParserState::prefetchImports (xmlNode *root)
+{
+  for (auto head : xmlFindAllChildren (root, "head"))
+    this->prefetchHeadImports (head);
+}
+
+/**
+ * @brief Starts reading the documents imported by the \<head\> element.
+ *
+ * Called by ParserState::prefetchImports() in DOM mode, and by
+ * ParserState::processReader() in streaming mode, once the reader has
+ * expanded the \<head\> element.
+ *
+ * @param head The \<head\> node.
+ */
+void
+ParserState::prefetchHeadImports (xmlNode *head)
+{
+  string main_uri = this->getURI ();
+
+  for (xmlNode *base = head->children; base; base = base->next)
+    {
+      if (base->type != XML_ELEMENT_NODE)
+        continue;
+
+      for (auto node : xmlFindAllChildren (base, "importBase"))
+        {
+          string uri;
+          if (!xmlGetPropAsString (node, "documentURI", &uri) || uri == "")
+            continue;
+
+          uri = parser_import_resolve_uri (uri, main_uri);
+          parser_import_unref (parser_import_fetch (uri, true));
+        }
+    }
+}
+
 /**
  * @brief Starts the processing of \<importBase\> element.
  *
@@ -3408,6 +3953,13 @@ xmlDocCleanup (void *ptr)
   xmlFreeDoc ((xmlDoc *) ptr);
 }
 
+/// Cleans up the list of imported URIs associated with #Document.
+static void
+importsCleanup (void *ptr)
+{
+  delete (list<string> *) ptr;
+}
+
 bool
 ParserState::pushImportBase (ParserState *st, ParserElt *elt)
 {
@@ -3416,12 +3968,14 @@ ParserState::pushImportBase (ParserState *st, ParserElt *elt)
   string imported_uri;
   string main_uri;
 
+  ParserImport *imp;
   xmlDoc *xml;
   xmlNode *root;
   xmlNode *head;
 
   list<xmlNode *> children;
   bool status;
+  Time t0;
 
   g_assert (st->eltCacheIndexParent (elt->getNode (), &parent_elt));
   g_assert (elt->getAttribute ("alias", &alias));
@@ -3432,12 +3986,7 @@ ParserState::pushImportBase (ParserState *st, ParserElt *elt)
     main_uri = st->getURI ();
 
   // if imported_uri is relative path build a new path based in main_uri
-  if (!xpathisabs (imported_uri) && main_uri != "")
-    {
-      imported_uri = xpathbuild (xpathdirname (xpathfromuri (main_uri)),
-                                 imported_uri);
-    }
-  imported_uri = xurifromsrc (imported_uri, "");
+  imported_uri = parser_import_resolve_uri (imported_uri, main_uri);
 
   // Push import alias and path onto alias stack.
   if (unlikely (!st->aliasStackPush (alias, imported_uri)))
@@ -3445,15 +3994,44 @@ ParserState::pushImportBase (ParserState *st, ParserElt *elt)
       return st->errEltImport (elt->getNode (), "circular import");
     }
 
-  // Read the imported document.
-  xml = xmlReadFile (imported_uri.c_str (), nullptr, PARSER_LIBXML_FLAGS);
-  if (unlikely (xml == nullptr))
+  // Get the imported document from cache, or read it.
+  t0 = PARSER_NOW ();
+  imp = parser_import_fetch (imported_uri, false);
+  parser_import_wait (imp);
+  st->_stats.read += PARSER_NOW () - t0;
+  if (unlikely (imp->xml == nullptr))
     {
-      string errmsg = xmlGetLastErrorAsString ();
+      string errmsg = imp->errmsg;
+      parser_import_unref (imp);
       return st->errEltImport (elt->getNode (), errmsg);
     }
 
-  UDATA_SET (elt, "xmlDoc", xml, xmlDocCleanup);
+  // Element cache is indexed by node; so if the shared document was
+  // already processed by this state, process a private copy of it.
+  if (st->_importDocs.insert (imp->xml).second)
+    {
+      xml = imp->xml;
+      UDATA_SET (elt, "import", imp, parser_import_unref);
+    }
+  else
+    {
+      xml = xmlCopyDoc (imp->xml, 1);
+      g_assert_nonnull (xml);
+      parser_import_unref (imp);
+      UDATA_SET (elt, "xmlDoc", xml, xmlDocCleanup);
+    }
+
+  // Record the imported URI in the resulting document.
+  {
+    list<string> *imports;
+    if (!st->_doc->getData ("imports", (void **) &imports))
+      {
+        imports = new list<string> ();
+        st->_doc->setData ("imports", imports, importsCleanup);
+      }
+    imports->push_back (imported_uri);
+  }
+
   root = xmlDocGetRootElement (xml);
   g_assert_nonnull (root);
 
@@ -4154,12 +4732,22 @@ ParserState::pushBind (ParserState *st, ParserElt *elt)
 
 /// Helper function used by Parser::parseBuffer() and Parser::parseFile().
 static Document *
-process (xmlDoc *xml, int width, int height, string *errmsg)
+process (xmlDoc *xml, int width, int height, string *errmsg,
+         ParserStats *stats)
 {
   ParserState st (width, height);
   Document *doc;
 
   doc = st.process (xml);
+  if (stats != nullptr)
+    {
+      stats->read += st.getStats ()->read;
+      stats->process = st.getStats ()->process;
+      stats->resolve = st.getStats ()->resolve;
+      stats->elements = st.getStats ()->elements;
+      stats->cached = st.getStats ()->cached;
+    }
+
   if (unlikely (doc == nullptr))
     {
       g_assert (st.getError (errmsg) != ParserState::ERROR_NONE);
@@ -4169,6 +4757,37 @@ process (xmlDoc *xml, int width, int height, string *errmsg)
   return doc;
 }
 
+/// Helper function used by Parser::parseBufferStreaming() and
+/// Parser::parseFileStreaming().
+static Document *
+processReader (xmlTextReader *reader, int width, int height,
+               string *errmsg, ParserStats *stats)
+{
+  ParserState st (width, height);
+  Document *doc;
+
+  doc = st.processReader (reader);
+  if (stats != nullptr)
+    {
+      stats->read = st.getStats ()->read;
+      stats->process = st.getStats ()->process;
+      stats->resolve = st.getStats ()->resolve;
+      stats->elements = st.getStats ()->elements;
+      stats->cached = st.getStats ()->cached;
+    }
+
+  if (unlikely (doc == nullptr))
+    {
+      if (st.getError (errmsg) == ParserState::ERROR_NONE)
+        tryset (errmsg, xmlGetLastErrorAsString ());
+    }
+
+  // No node is preserved, so the reader frees its document.
+  xmlFreeTextReader (reader);
+
+  return doc;
+}
+
 /**
  * @brief Parses NCL document from memory buffer.
  * @fn Parser::parseBuffer
@@ -4177,43 +4796,66 @@ process (xmlDoc *xml, int width, int height, string *errmsg)
  * @param width Initial screen width (in pixels).
  * @param height Initial screen height (in pixels).
  * @param[out] errmsg Variable to store the error message (if any).
+ * @param[out] stats Variable to store the timing counters (if any).
  * @return The resulting #Document if successful, or null otherwise.
  */
 Document *
 Parser::parseBuffer (const void *buf, size_t size, int width, int height,
-                     string *errmsg)
+                     string *errmsg, ParserStats *stats)
 {
   xmlDoc *xml;
   Document *doc;
+  Time t0;
+
+  t0 = PARSER_NOW ();
+  if (stats != nullptr)
+    *stats = { 0, 0, 0, 0, 0, 0 };
 
   xml = xmlReadMemory ((const char *) buf, (int) size, nullptr, nullptr,
                        PARSER_LIBXML_FLAGS);
+  if (stats != nullptr)
+    stats->read = PARSER_NOW () - t0;
+
   if (unlikely (xml == nullptr))
     {
       tryset (errmsg, xmlGetLastErrorAsString ());
       return nullptr;
     }
 
-  doc = process (xml, width, height, errmsg);
+  doc = process (xml, width, height, errmsg, stats);
   xmlFreeDoc (xml);
+
+  if (stats != nullptr)
+    stats->total = PARSER_NOW () - t0;
+
   return doc;
 }
 
 /**
  * @brief Parses NCL document from file.
+ *
+ * The URIs of the documents imported by the file, if any, are attached to
+ * the resulting document as the user data "imports" (a list of strings).
+ *
  * @param path File path.
  * @param width Initial screen width (in pixels).
  * @param height Initial screen height (in pixels).
  * @param[out] errmsg Variable to store the error message (if any).
+ * @param[out] stats Variable to store the timing counters (if any).
  * @return The resulting #Document if successful, or null otherwise.
  */
 Document *
 Parser::parseFile (const string &path, int width, int height,
-                   string *errmsg)
+                   string *errmsg, ParserStats *stats)
 {
   xmlDoc *xml;
   Document *doc;
   string uri = path;
+  Time t0;
+
+  t0 = PARSER_NOW ();
+  if (stats != nullptr)
+    *stats = { 0, 0, 0, 0, 0, 0 };
 
   // Makes the path absolute based in the current dir
   if (!xpathisabs (path))
@@ -4222,6 +4864,9 @@ Parser::parseFile (const string &path, int width, int height,
   uri = xurifromsrc (uri, "");
 
   xml = xmlReadFile (uri.c_str (), nullptr, PARSER_LIBXML_FLAGS);
+  if (stats != nullptr)
+    stats->read = PARSER_NOW () - t0;
+
   if (unlikely (xml == nullptr))
     {
       tryset (errmsg, xmlGetLastErrorAsString ());
@@ -4229,9 +4874,131 @@ Parser::parseFile (const string &path, int width, int height,
       return nullptr;
     }
 
-  doc = process (xml, width, height, errmsg);
+  doc = process (xml, width, height, errmsg, stats);
   xmlFreeDoc (xml);
 
+  if (stats != nullptr)
+    stats->total = PARSER_NOW () - t0;
+
+  return doc;
+}
+
+/**
+ * @brief Parses NCL document from memory buffer in streaming mode.
+ *
+ * Same as Parser::parseBuffer(), but processes the document while it is
+ * being read, without first building its complete DOM tree.
+ *
+ * @param buf Buffer.
+ * @param size Buffer size in bytes.
+ * @param width Initial screen width (in pixels).
+ * @param height Initial screen height (in pixels).
+ * @param[out] errmsg Variable to store the error message (if any).
+ * @param[out] stats Variable to store the timing counters (if any).
+ * @return The resulting #Document if successful, or null otherwise.
+ */
+Document *
+Parser::parseBufferStreaming (const void *buf, size_t size, int width,
+                              int height, string *errmsg,
+                              ParserStats *stats)
+{
+  xmlTextReader *reader;
+  Document *doc;
+  Time t0;
+
+  t0 = PARSER_NOW ();
+  if (stats != nullptr)
+    *stats = { 0, 0, 0, 0, 0, 0 };
+
+  reader = xmlReaderForMemory ((const char *) buf, (int) size, nullptr,
+                               nullptr, PARSER_LIBXML_READER_FLAGS);
+  if (unlikely (reader == nullptr))
+    {
+      tryset (errmsg, xmlGetLastErrorAsString ());
+      return nullptr;
+    }
+
+  doc = processReader (reader, width, height, errmsg, stats);
+
+  if (stats != nullptr)
+    stats->total = PARSER_NOW () - t0;
+
+  return doc;
+}
+
+/**
+ * @brief Initializes the XML library used by the parser.
+ *
+ * Must be called by the main thread before documents are parsed by other
+ * threads; calling it more than once is harmless.
+ */
+void
+Parser::init ()
+{
+  xmlInitParser ();
+}
+
+/**
+ * @brief Drops all documents from the import cache.
+ *
+ * Documents still in use by a parser are freed when it is done with them.
+ * The cache outlives formatters, so that it is reused by the next document
+ * that imports the same bases; embedders call this function only when
+ * they want to release its memory.
+ */
+void
+Parser::clearImportCache ()
+{
+  g_mutex_lock (&parser_import_mutex);
+  parser_import_trim_unlocked (0);
+  g_mutex_unlock (&parser_import_mutex);
+}
+
+/**
+ * @brief Parses NCL document from file in streaming mode.
+ *
+ * Same as Parser::parseFile(), but processes the document while it is
+ * being read, without first building its complete DOM tree.
+ *
+ * @param path File path.
+ * @param width Initial screen width (in pixels).
+ * @param height Initial screen height (in pixels).
+ * @param[out] errmsg Variable to store the error message (if any).
+ * @param[out] stats Variable to store the timing counters (if any).
+ * @return The resulting #Document if successful, or null otherwise.
+ */
+Document *
+Parser::parseFileStreaming (const string &path, int width, int height,
+                            string *errmsg, ParserStats *stats)
+{
+  xmlTextReader *reader;
+  Document *doc;
+  string uri = path;
+  Time t0;
+
+  t0 = PARSER_NOW ();
+  if (stats != nullptr)
+    *stats = { 0, 0, 0, 0, 0, 0 };
+
+  // Makes the path absolute based in the current dir
+  if (!xpathisabs (path))
+    uri = xpathmakeabs (path);
+
+  uri = xurifromsrc (uri, "");
+
+  reader = xmlReaderForFile (uri.c_str (), nullptr,
+                             PARSER_LIBXML_READER_FLAGS);
+  if (unlikely (reader == nullptr))
+    {
+      tryset (errmsg, xmlGetLastErrorAsString ());
+      return nullptr;
+    }
+
+  doc = processReader (reader, width, height, errmsg, stats);
+
+  if (stats != nullptr)
+    stats->total = PARSER_NOW () - t0;
+
   return doc;
 }
 
@@ -22,11 +22,35 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
+/**
+ * @brief Parser timing counters.
+ *
+ * Wall-clock time spent in each phase of parsing.
+ */
+typedef struct ParserStats
+{
+  Time read;      ///< Reading XML, including imported documents.
+  Time process;   ///< Processing elements (push & pop).
+  Time resolve;   ///< Resolving references at the end of \<ncl\>.
+  Time total;     ///< Whole parsing.
+  guint elements; ///< Number of elements processed.
+  guint cached;   ///< Number of elements kept in element cache.
+} ParserStats;
+
 class Parser
 {
 public:
-  static Document *parseBuffer (const void *, size_t, int, int, string *);
-  static Document *parseFile (const string &, int, int, string *);
+  static void init ();
+  static Document *parseBuffer (const void *, size_t, int, int, string *,
+                                ParserStats *stats = nullptr);
+  static Document *parseFile (const string &, int, int, string *,
+                              ParserStats *stats = nullptr);
+  static Document *parseBufferStreaming (const void *, size_t, int, int,
+                                         string *,
+                                         ParserStats *stats = nullptr);
+  static Document *parseFileStreaming (const string &, int, int, string *,
+                                       ParserStats *stats = nullptr);
+  static void clearImportCache ();
 };
 
 GINGA_NAMESPACE_END
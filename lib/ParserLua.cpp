@@ -766,6 +766,11 @@ process (lua_State *L, const string &path, string *errmsg)
     return nullptr;
   }
 
+  // Every object exists by now, so property references in action
+  // parameters can be resolved once and for all.
+  for (auto ctx : *doc->getContexts ())
+    ctx->compileLinks ();
+
   return doc;
 }
 
@@ -94,64 +94,144 @@ mime_table_index (const string &key, string *result)
   return true;
 }
 
-// Property table.
+// Property table, indexed by property code.
 typedef struct PlayerPropertyInfo
 {
   Player::Property code; // property code
+  const char *name;      // canonical name (null if not a real property)
   bool init;             // whether it should be initialized
   string defval;         // default value
 } PlayerPropertyInfo;
 
-static map<string, PlayerPropertyInfo> player_property_map = {
-  { "background", { Player::PROP_BACKGROUND, true, "" } },
-  { "balance", { Player::PROP_BALANCE, false, "0.0" } },
-  { "bass", { Player::PROP_BASS, false, "0" } },
-  { "bottom", { Player::PROP_BOTTOM, false, "0%" } },
-  { "bounds", { Player::PROP_BOUNDS, false, "0%,0%,100%,100%" } },
-  { "debug", { Player::PROP_DEBUG, true, "false" } },
-  { "duration", { Player::PROP_DURATION, true, "indefinite" } },
-  { "focusIndex", { Player::PROP_FOCUS_INDEX, true, "" } },
-  { "fontBgColor", { Player::PROP_FONT_BG_COLOR, true, "" } },
-  { "fontColor", { Player::PROP_FONT_COLOR, true, "black" } },
-  { "fontFamily", { Player::PROP_FONT_FAMILY, true, "sans" } },
-  { "fontSize", { Player::PROP_FONT_SIZE, true, "12" } },
-  { "fontStyle", { Player::PROP_FONT_STYLE, true, "" } },
-  { "fontVariant", { Player::PROP_FONT_VARIANT, true, "" } },
-  { "fontWeight", { Player::PROP_FONT_WEIGHT, true, "" } },
-  { "freeze", { Player::PROP_FREEZE, true, "false" } },
-  { "freq", { Player::PROP_FREQ, true, "440" } },
-  { "height", { Player::PROP_HEIGHT, true, "100%" } },
-  { "horzAlign", { Player::PROP_HORZ_ALIGN, true, "left" } },
-  { "left", { Player::PROP_LEFT, true, "0" } },
-  { "location", { Player::PROP_LOCATION, false, "0,0" } },
-  { "mute", { Player::PROP_MUTE, false, "false" } },
-  { "right", { Player::PROP_RIGHT, false, "0%" } },
-  { "size", { Player::PROP_SIZE, false, "100%,100%" } },
-  { "speed", { Player::PROP_SPEED, false, "1" } },
-  { "time", { Player::PROP_TIME, false, "indefinite" } },
-  { "top", { Player::PROP_TOP, true, "0" } },
-  { "transparency", { Player::PROP_TRANSPARENCY, true, "0%" } },
-  { "treble", { Player::PROP_TREBLE, false, "0" } },
-  { "vertAlign", { Player::PROP_VERT_ALIGN, true, "top" } },
-  { "visible", { Player::PROP_VISIBLE, true, "true" } },
-  { "volume", { Player::PROP_VOLUME, false, "100%" } },
-  { "wave", { Player::PROP_WAVE, true, "sine" } },
-  { "width", { Player::PROP_WIDTH, true, "100%" } },
-  { "zIndex", { Player::PROP_Z_INDEX, true, "0" } },
-  { "zOrder", { Player::PROP_Z_ORDER, true, "0" } },
-  { "uri", { Player::PROP_URI, true, "" } },
-  { "type", { Player::PROP_TYPE, true, "application/x-ginga-timer" } },
+static const PlayerPropertyInfo player_property_table[] = {
+  { Player::PROP_UNKNOWN, nullptr, false, "" },
+  { Player::PROP_BACKGROUND, "background", true, "" },
+  { Player::PROP_BALANCE, "balance", false, "0.0" },
+  { Player::PROP_BASS, "bass", false, "0" },
+  { Player::PROP_BOTTOM, "bottom", false, "0%" },
+  { Player::PROP_BOUNDS, "bounds", false, "0%,0%,100%,100%" },
+  { Player::PROP_DEBUG, "debug", true, "false" },
+  { Player::PROP_DURATION, "duration", true, "indefinite" },
+  { Player::PROP_EXPLICIT_DUR, nullptr, false, "" },
+  { Player::PROP_FOCUS_INDEX, "focusIndex", true, "" },
+  { Player::PROP_FONT_BG_COLOR, "fontBgColor", true, "" },
+  { Player::PROP_FONT_COLOR, "fontColor", true, "black" },
+  { Player::PROP_FONT_FAMILY, "fontFamily", true, "sans" },
+  { Player::PROP_FONT_SIZE, "fontSize", true, "12" },
+  { Player::PROP_FONT_STYLE, "fontStyle", true, "" },
+  { Player::PROP_FONT_VARIANT, "fontVariant", true, "" },
+  { Player::PROP_FONT_WEIGHT, "fontWeight", true, "" },
+  { Player::PROP_FREEZE, "freeze", true, "false" },
+  { Player::PROP_FREQ, "freq", true, "440" },
+  { Player::PROP_HEIGHT, "height", true, "100%" },
+  { Player::PROP_HORZ_ALIGN, "horzAlign", true, "left" },
+  { Player::PROP_LEFT, "left", true, "0" },
+  { Player::PROP_LOCATION, "location", false, "0,0" },
+  { Player::PROP_MUTE, "mute", false, "false" },
+  { Player::PROP_RIGHT, "right", false, "0%" },
+  { Player::PROP_SIZE, "size", false, "100%,100%" },
+  { Player::PROP_SPEED, "speed", false, "1" },
+  { Player::PROP_TIME, "time", false, "indefinite" },
+  { Player::PROP_TOP, "top", true, "0" },
+  { Player::PROP_TRANSPARENCY, "transparency", true, "0%" },
+  { Player::PROP_TREBLE, "treble", false, "0" },
+  { Player::PROP_TYPE, "type", true, "application/x-ginga-timer" },
+  { Player::PROP_URI, "uri", true, "" },
+  { Player::PROP_VERT_ALIGN, "vertAlign", true, "top" },
+  { Player::PROP_VISIBLE, "visible", true, "true" },
+  { Player::PROP_VOLUME, "volume", false, "100%" },
+  { Player::PROP_WAVE, "wave", true, "sine" },
+  { Player::PROP_WIDTH, "width", true, "100%" },
+  { Player::PROP_Z_INDEX, "zIndex", true, "0" },
+  { Player::PROP_Z_ORDER, "zOrder", true, "0" },
 };
 
-static map<string, string> player_property_aliases = {
-  { "backgroundColor", "background" },
-  { "balanceLevel", "balance" },
-  { "bassLevel", "bass" },
-  { "explicitDur", "duration" },
-  { "soundLevel", "volume" },
-  { "rate", "speed" },
-  { "trebleLevel", "treble" },
-};
+G_STATIC_ASSERT (G_N_ELEMENTS (player_property_table)
+                 == Player::PROP_COUNT);
+
+// Hash of property names.  The coefficients are such that no two known
+// names or aliases have the same hash, which makes the switch in
+// player_property_lookup() a perfect hash: a collision introduced by a
+// new name shows up as a duplicate case value at compile time.
+static constexpr guint
+player_property_hash (const char *s, size_t n)
+{
+  return (n < 2) ? 0
+                 : ((guint) s[0] * 3 + (guint) s[1] * 19
+                    + (guint) s[n - 1] * 7 + (guint) n)
+                       % 128;
+}
+
+// Gets the code of property or alias \p name.
+static Player::Property
+player_property_lookup (const string &name)
+{
+#define PLAYER_PROPERTY(str, code)                                      \
+  case player_property_hash (str, sizeof (str) - 1):                    \
+    return (name == str) ? Player::code : Player::PROP_UNKNOWN;
+
+  switch (player_property_hash (name.c_str (), name.length ()))
+    {
+      PLAYER_PROPERTY ("background", PROP_BACKGROUND)
+      PLAYER_PROPERTY ("balance", PROP_BALANCE)
+      PLAYER_PROPERTY ("bass", PROP_BASS)
+      PLAYER_PROPERTY ("bottom", PROP_BOTTOM)
+      PLAYER_PROPERTY ("bounds", PROP_BOUNDS)
+      PLAYER_PROPERTY ("debug", PROP_DEBUG)
+      PLAYER_PROPERTY ("duration", PROP_DURATION)
+      PLAYER_PROPERTY ("focusIndex", PROP_FOCUS_INDEX)
+      PLAYER_PROPERTY ("fontBgColor", PROP_FONT_BG_COLOR)
+      PLAYER_PROPERTY ("fontColor", PROP_FONT_COLOR)
+      PLAYER_PROPERTY ("fontFamily", PROP_FONT_FAMILY)
+      PLAYER_PROPERTY ("fontSize", PROP_FONT_SIZE)
+      PLAYER_PROPERTY ("fontStyle", PROP_FONT_STYLE)
+      PLAYER_PROPERTY ("fontVariant", PROP_FONT_VARIANT)
+      PLAYER_PROPERTY ("fontWeight", PROP_FONT_WEIGHT)
+      PLAYER_PROPERTY ("freeze", PROP_FREEZE)
+      PLAYER_PROPERTY ("freq", PROP_FREQ)
+      PLAYER_PROPERTY ("height", PROP_HEIGHT)
+      PLAYER_PROPERTY ("horzAlign", PROP_HORZ_ALIGN)
+      PLAYER_PROPERTY ("left", PROP_LEFT)
+      PLAYER_PROPERTY ("location", PROP_LOCATION)
+      PLAYER_PROPERTY ("mute", PROP_MUTE)
+      PLAYER_PROPERTY ("right", PROP_RIGHT)
+      PLAYER_PROPERTY ("size", PROP_SIZE)
+      PLAYER_PROPERTY ("speed", PROP_SPEED)
+      PLAYER_PROPERTY ("time", PROP_TIME)
+      PLAYER_PROPERTY ("top", PROP_TOP)
+      PLAYER_PROPERTY ("transparency", PROP_TRANSPARENCY)
+      PLAYER_PROPERTY ("treble", PROP_TREBLE)
+      PLAYER_PROPERTY ("type", PROP_TYPE)
+      PLAYER_PROPERTY ("uri", PROP_URI)
+      PLAYER_PROPERTY ("vertAlign", PROP_VERT_ALIGN)
+      PLAYER_PROPERTY ("visible", PROP_VISIBLE)
+      PLAYER_PROPERTY ("volume", PROP_VOLUME)
+      PLAYER_PROPERTY ("wave", PROP_WAVE)
+      PLAYER_PROPERTY ("width", PROP_WIDTH)
+      PLAYER_PROPERTY ("zIndex", PROP_Z_INDEX)
+      PLAYER_PROPERTY ("zOrder", PROP_Z_ORDER)
+      // Aliases.
+      PLAYER_PROPERTY ("backgroundColor", PROP_BACKGROUND)
+      PLAYER_PROPERTY ("balanceLevel", PROP_BALANCE)
+      PLAYER_PROPERTY ("bassLevel", PROP_BASS)
+      PLAYER_PROPERTY ("explicitDur", PROP_DURATION)
+      PLAYER_PROPERTY ("rate", PROP_SPEED)
+      PLAYER_PROPERTY ("soundLevel", PROP_VOLUME)
+      PLAYER_PROPERTY ("trebleLevel", PROP_TREBLE)
+    default:
+      return Player::PROP_UNKNOWN;
+    }
+
+#undef PLAYER_PROPERTY
+}
+
+// Tests whether two rectangles are equal.
+static inline bool
+rect_equal (const Rect &a, const Rect &b)
+{
+  return a.x == b.x && a.y == b.y && a.width == b.width
+         && a.height == b.height;
+}
 
 // Public.
 
@@ -170,16 +250,24 @@ Player::Player (Formatter *formatter, Media *media)
   _dirty = true;
   _animator = new PlayerAnimator (_formatter, &_time);
   _surface = nullptr;
+  _staticSurface = false;
+  _scaled = nullptr;
+  _hidden = false;
   _opengl = _formatter->getOptionBool ("opengl");
   _gltexture = 0;
+  _damaged = true;
+  _damageState.visible = false;
   this->resetProperties ();
 }
 
 Player::~Player ()
 {
+  _formatter->displayListRemove (this);
   delete _animator;
   if (_surface != nullptr)
     cairo_surface_destroy (_surface);
+  if (_scaled != nullptr)
+    cairo_surface_destroy (_scaled);
   if (_gltexture)
     GL::delete_texture (&_gltexture);
   _properties.clear ();
@@ -204,6 +292,44 @@ Player::isFocused ()
   return _prop.focusIndex != "" && _prop.focusIndex == _currentFocus;
 }
 
+bool
+Player::isVisible ()
+{
+  return _prop.visible;
+}
+
+// Tests whether player covers its whole rect with opaque pixels, i.e.,
+// whether it hides everything below it.  Here only an opaque background
+// counts; players whose content is opaque reimplement this.
+bool
+Player::isOpaque ()
+{
+  return this->coversRect () && _prop.bgColor.alpha >= 1.;
+}
+
+// Tests whether player is hidden from screen, i.e., whether it is
+// invisible, off-screen, or completely covered by opaque players.
+bool
+Player::isHidden ()
+{
+  return _hidden;
+}
+
+// Sets whether player is hidden from screen.  This is called by the
+// formatter on every tick; players can reimplement it to stop producing
+// content nobody sees.
+void
+Player::setHidden (bool hidden)
+{
+  _hidden = hidden;
+}
+
+Rect
+Player::getRect ()
+{
+  return _prop.rect;
+}
+
 Time
 Player::getTime ()
 {
@@ -247,6 +373,10 @@ Player::start ()
   _state = OCCURRING;
   _time = 0;
   _eos = false;
+  _hidden = false;
+  _damaged = true;
+  _damageState.visible = false;
+  _formatter->displayListAdd (this);
   this->reload ();
   _animator->scheduleTransition ("start", &_prop.rect, &_prop.bgColor,
                                  &_prop.alpha, &_crop);
@@ -257,6 +387,12 @@ Player::stop ()
 {
   g_assert (_state != SLEEPING);
   _state = SLEEPING;
+  _formatter->displayListRemove (this);
+  if (_scaled != nullptr)
+    {
+      cairo_surface_destroy (_scaled);
+      _scaled = nullptr;
+    }
   this->resetProperties ();
 }
 
@@ -277,53 +413,51 @@ Player::resume ()
 string
 Player::getProperty (string const &name)
 {
-  return (_properties.count (name) != 0) ? _properties[name] : "";
+  Player::Property code;
+  map<string, string>::iterator it;
+
+  code = player_property_lookup (name);
+  if (code != Player::PROP_UNKNOWN)
+    return _knownProperties[code];
+
+  it = _properties.find (name);
+  return (it != _properties.end ()) ? it->second : "";
 }
 
 void
 Player::setProperty (const string &name, const string &value)
 {
   Player::Property code;
-  bool use_defval;
-  string defval;
-  string _value;
-
-  if (name == "transIn" || name == "transOut")
-    _animator->setTransitionProperties (name, value);
+  const string *_value;
 
-  use_defval = false;
-  _value = value;
-
-  code = Player::getPlayerProperty (name, &defval);
+  code = player_property_lookup (name);
   if (code == Player::PROP_UNKNOWN)
-    goto done;
-
-  if (_value == "")
     {
-      use_defval = true;
-      _value = defval;
+      if (name == "transIn" || name == "transOut")
+        _animator->setTransitionProperties (name, value);
+      _properties[name] = value;
+      return;
     }
 
-  if (unlikely (!this->doSetProperty (code, name, _value)))
+  _value = (value == "") ? &player_property_table[code].defval : &value;
+  if (unlikely (!this->doSetProperty (code, name, *_value)))
     {
       ERROR ("property '%s': bad value '%s'", name.c_str (),
-             _value.c_str ());
+             _value->c_str ());
     }
 
-  if (use_defval) // restore value
-    _value = "";
-
-done:
-  _properties[name] = _value;
-  return;
+  _knownProperties[code] = value;
 }
 
 void
 Player::resetProperties ()
 {
-  for (auto it : player_property_map)
-    if (it.second.init)
-      this->setProperty (it.first, "");
+  for (auto &info : player_property_table)
+    if (info.init)
+      this->setProperty (info.name, "");
+
+  for (auto &value : _knownProperties)
+    value.clear ();
   _properties.clear ();
 }
 
@@ -344,11 +478,21 @@ Player::schedulePropertyAnimation (const string &name, const string &from,
 void
 Player::reload ()
 {
+  if (_scaled != nullptr)
+    {
+      cairo_surface_destroy (_scaled);
+      _scaled = nullptr;
+    }
   _dirty = false;
 }
 
+// Brings player up to date with the current frame: advances animations,
+// reloads dirty content, and, in subclasses, consumes new content (video
+// frames, NCLua cycles and the events they post).  The formatter calls
+// this on every frame for every player in display list, before deciding
+// whether to draw it.
 void
-Player::redraw (cairo_t *cr)
+Player::update ()
 {
   g_assert (_state != SLEEPING);
   _animator->update (&_prop.rect, &_prop.bgColor, &_prop.alpha, &_crop);
@@ -362,6 +506,19 @@ Player::redraw (cairo_t *cr)
     {
       this->reload ();
     }
+}
+
+// Draws player.  Player::update() must have been called for the current
+// frame.
+void
+Player::redraw (cairo_t *cr)
+{
+  g_assert (_state != SLEEPING);
+
+  if (!_prop.visible || !(_prop.rect.width > 0 && _prop.rect.height > 0))
+    {
+      return; // nothing to do
+    }
 
   if (_prop.bgColor.alpha > 0)
     {
@@ -388,29 +545,12 @@ Player::redraw (cairo_t *cr)
 
   if (_opengl)
     {
-      if (_gltexture)
-        {
-          GL::draw_quad (_prop.rect.x, _prop.rect.y, _prop.rect.width,
-                         _prop.rect.height, _gltexture,
-                         (GLfloat) (_prop.alpha / 255.));
-        }
+      this->redrawTexture ();
     }
   else
     {
       if (_surface != nullptr)
-        {
-          double sx, sy;
-          sx = (double) _prop.rect.width
-               / cairo_image_surface_get_width (_surface);
-          sy = (double) _prop.rect.height
-               / cairo_image_surface_get_height (_surface);
-          cairo_save (cr);
-          cairo_translate (cr, _prop.rect.x, _prop.rect.y);
-          cairo_scale (cr, sx, sy);
-          cairo_set_source_surface (cr, _surface, 0., 0.);
-          cairo_paint_with_alpha (cr, _prop.alpha / 255.);
-          cairo_restore (cr);
-        }
+        this->redrawSurface (cr);
     }
 
   if (this->isFocused ())
@@ -470,11 +610,83 @@ Player::redraw (cairo_t *cr)
     }
 }
 
+// Returns the time until the player needs the next tick, or
+// GINGA_TIME_NONE if the player does not change by itself.
+Time
+Player::getTimeToNextDeadline ()
+{
+  if (_state != OCCURRING)
+    return GINGA_TIME_NONE;
+  if (_eos || _animator->isRunning ())
+    return 0;
+  return GINGA_TIME_NONE;
+}
+
 void
 Player::sendKeyEvent (unused (const string &key), unused (bool press))
 {
 }
 
+void
+Player::damage ()
+{
+  _damaged = true;
+}
+
+// Adds to region the area of the screen that needs to be repainted due to
+// changes in player since the last call to this function.
+void
+Player::getDamage (cairo_region_t *region)
+{
+  bool focused;
+  bool debug;
+
+  g_assert_nonnull (region);
+  _animator->update (&_prop.rect, &_prop.bgColor, &_prop.alpha, &_crop);
+
+  focused = this->isFocused ();
+  debug = _prop.debug || _formatter->getOptionBool ("debug");
+
+  if (!(_damaged || _dirty || this->isContentDamaged ())
+      && _damageState.visible == _prop.visible
+      && (!_prop.visible
+          || (rect_equal (_damageState.rect, _prop.rect)
+              && gdk_rgba_equal (&_damageState.bgColor, &_prop.bgColor)
+              && _damageState.alpha == _prop.alpha
+              && _damageState.focused == focused
+              && _damageState.debug == debug
+              && _damageState.zindex == _prop.zindex
+              && _damageState.zorder == _prop.zorder)))
+    {
+      return; // nothing to do
+    }
+
+  // The focus border is stroked over the rect edges, so we grow the
+  // damaged rects by one pixel on each side.
+  if (_damageState.visible)
+    {
+      Rect old = _damageState.rect;
+      old = { old.x - 1, old.y - 1, old.width + 2, old.height + 2 };
+      cairo_region_union_rectangle (region, &old);
+    }
+  if (_prop.visible && _state != SLEEPING)
+    {
+      Rect cur = _prop.rect;
+      cur = { cur.x - 1, cur.y - 1, cur.width + 2, cur.height + 2 };
+      cairo_region_union_rectangle (region, &cur);
+    }
+
+  _damaged = false;
+  _damageState.rect = _prop.rect;
+  _damageState.bgColor = _prop.bgColor;
+  _damageState.alpha = _prop.alpha;
+  _damageState.visible = _prop.visible && _state != SLEEPING;
+  _damageState.focused = focused;
+  _damageState.debug = debug;
+  _damageState.zindex = _prop.zindex;
+  _damageState.zorder = _prop.zorder;
+}
+
 // Public: Static.
 
 // Current focus index value.
@@ -495,26 +707,11 @@ Player::setCurrentFocus (const string &index)
 Player::Property
 Player::getPlayerProperty (const string &name, string *defval)
 {
-  map<string, PlayerPropertyInfo>::iterator it;
-  PlayerPropertyInfo *info;
-  string _name = name;
+  Player::Property code;
 
-  if ((it = player_property_map.find (_name)) == player_property_map.end ())
-    {
-      map<string, string>::iterator italias;
-      if ((italias = player_property_aliases.find (_name))
-          == player_property_aliases.end ())
-        {
-          tryset (defval, "");
-          return PROP_UNKNOWN;
-        }
-      _name = italias->second;
-      it = player_property_map.find (_name);
-      g_assert (it != player_property_map.end ());
-    }
-  info = &it->second;
-  tryset (defval, info->defval);
-  return info->code;
+  code = player_property_lookup (name);
+  tryset (defval, player_property_table[code].defval);
+  return code;
 }
 
 Player *
@@ -714,11 +911,13 @@ Player::doSetProperty (Property code, unused (const string &name),
     case PROP_Z_INDEX:
       {
         _prop.zindex = xstrtoint (value, 10);
+        _formatter->displayListUpdate (this);
         break;
       }
     case PROP_Z_ORDER:
       {
         _prop.zorder = xstrtoint (value, 10);
+        _formatter->displayListUpdate (this);
         break;
       }
     case PROP_TRANSPARENCY:
@@ -766,14 +965,118 @@ Player::doSetProperty (Property code, unused (const string &name),
   return true;
 }
 
+bool
+Player::isContentDamaged ()
+{
+  return false;
+}
+
+// Returns extra player-specific lines to show in the debugging info.
+string
+Player::getDebuggingInfo ()
+{
+  return "";
+}
+
+// Draws player texture into player rect (OpenGL only).
+void
+Player::redrawTexture ()
+{
+  if (_gltexture)
+    {
+      GL::draw_quad (_prop.rect.x, _prop.rect.y, _prop.rect.width,
+                     _prop.rect.height, _gltexture,
+                     (GLfloat) (_prop.alpha / 255.));
+    }
+}
+
+// Tests whether player draws its whole rect at full opacity, i.e.,
+// whether it is opaque if whatever it draws there is.
+bool
+Player::coversRect ()
+{
+  return _prop.visible && _prop.alpha == 255 && _prop.rect.width > 0
+         && _prop.rect.height > 0 && _crop.empty ();
+}
+
 // Private.
 
+// Paints player surface scaled to player rect.  If the surface is static,
+// the scaled version is cached and painted unscaled in subsequent frames,
+// until the surface is reloaded or the rect size changes.  While an
+// animation is running, a stale cache is not rebuilt; the surface is
+// scaled on the fly instead.
+void
+Player::redrawSurface (cairo_t *cr)
+{
+  int width, height;
+  double sx, sy;
+
+  g_assert_nonnull (_surface);
+  width = _prop.rect.width;
+  height = _prop.rect.height;
+
+  if (_staticSurface
+      && (cairo_image_surface_get_width (_surface) != width
+          || cairo_image_surface_get_height (_surface) != height))
+    {
+      if (_scaled != nullptr
+          && (cairo_image_surface_get_width (_scaled) != width
+              || cairo_image_surface_get_height (_scaled) != height)
+          && !_animator->isRunning ())
+        {
+          cairo_surface_destroy (_scaled);
+          _scaled = nullptr;
+        }
+
+      if (_scaled == nullptr && !_animator->isRunning ())
+        {
+          cairo_t *scr;
+
+          _scaled = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, width,
+                                                height);
+          g_assert_nonnull (_scaled);
+          scr = cairo_create (_scaled);
+          g_assert_nonnull (scr);
+          cairo_scale (scr,
+                       (double) width
+                           / cairo_image_surface_get_width (_surface),
+                       (double) height
+                           / cairo_image_surface_get_height (_surface));
+          cairo_set_source_surface (scr, _surface, 0., 0.);
+          cairo_set_operator (scr, CAIRO_OPERATOR_SOURCE);
+          cairo_paint (scr);
+          cairo_destroy (scr);
+        }
+
+      if (_scaled != nullptr
+          && cairo_image_surface_get_width (_scaled) == width
+          && cairo_image_surface_get_height (_scaled) == height)
+        {
+          cairo_set_source_surface (cr, _scaled, _prop.rect.x,
+                                    _prop.rect.y);
+          cairo_paint_with_alpha (cr, _prop.alpha / 255.);
+          return;
+        }
+    }
+
+  sx = (double) width / cairo_image_surface_get_width (_surface);
+  sy = (double) height / cairo_image_surface_get_height (_surface);
+  cairo_save (cr);
+  cairo_translate (cr, _prop.rect.x, _prop.rect.y);
+  cairo_scale (cr, sx, sy);
+  cairo_set_source_surface (cr, _surface, 0., 0.);
+  cairo_paint_with_alpha (cr, _prop.alpha / 255.);
+  cairo_restore (cr);
+}
+
 void
 Player::redrawDebuggingInfo (cairo_t *cr)
 {
   cairo_surface_t *debug;
   string id;
   string str;
+  string extra;
   double sx, sy;
 
   id = _id;
@@ -789,12 +1092,32 @@ Player::redrawDebuggingInfo (cairo_t *cr)
                    ((double) GINGA_TIME_AS_MSECONDS (_time)) / 1000.,
                    _prop.rect.width, _prop.rect.height, _prop.rect.x,
                    _prop.rect.y, _prop.zindex);
+  extra = this->getDebuggingInfo ();
+  if (extra != "")
+    str += "\n" + extra;
 
   debug = PlayerText::renderSurface (
       str, "monospace", "", "", "7", { 1., 0, 0, 1. }, { 0, 0, 0, .75 },
       _prop.rect, "center", "middle", true, nullptr);
   g_assert_nonnull (debug);
 
+  // In OpenGL mode there is no cairo context; draw the info through a
+  // temporary texture.
+  if (_opengl)
+    {
+      GLuint gltex = 0;
+
+      cairo_surface_flush (debug);
+      GL::create_texture (&gltex, cairo_image_surface_get_width (debug),
+                          cairo_image_surface_get_height (debug),
+                          cairo_image_surface_get_data (debug));
+      GL::draw_quad (_prop.rect.x, _prop.rect.y, _prop.rect.width,
+                     _prop.rect.height, gltex);
+      GL::delete_texture (&gltex);
+      cairo_surface_destroy (debug);
+      return;
+    }
+
   sx = (double) _prop.rect.width / cairo_image_surface_get_width (debug);
   sy = (double) _prop.rect.height / cairo_image_surface_get_height (debug);
 
@@ -77,6 +77,7 @@ public:
     PROP_WIDTH,
     PROP_Z_INDEX,
     PROP_Z_ORDER,
+    PROP_COUNT, // number of property codes
   };
 
   Player (Formatter *, Media *);
@@ -85,6 +86,11 @@ public:
   State getState ();
   void getZ (int *, int *);
   bool isFocused ();
+  bool isVisible ();
+  virtual bool isOpaque ();
+  bool isHidden ();
+  virtual void setHidden (bool);
+  Rect getRect ();
 
   Time getTime ();
   void incTime (Time);
@@ -107,8 +113,13 @@ public:
   void schedulePropertyAnimation (const string &, const string &,
                                   const string &, Time);
   virtual void reload ();
+  virtual void update ();
   virtual void redraw (cairo_t *);
 
+  void damage ();
+  void getDamage (cairo_region_t *);
+  virtual Time getTimeToNextDeadline ();
+
   virtual void sendKeyEvent (const string &, bool);
 
   // For now, only for the lua player (which reimplements it).
@@ -137,8 +148,12 @@ protected:
   bool _dirty;               // true if surface should be reloaded
   PlayerAnimator *_animator; // associated animator
   list<int> _crop;           // polygon for cropping effect
+  bool _staticSurface;       // true if surface changes only on reload
+  cairo_surface_t *_scaled;  // static surface scaled to rect size
+  bool _hidden;              // true if not visible on screen
 
-  map<string, string> _properties; // property table
+  string _knownProperties[PROP_COUNT]; // values of known properties
+  map<string, string> _properties;     // values of unknown properties
   struct
   {
     Color bgColor;     // background color
@@ -154,10 +169,28 @@ protected:
     string uri;        // content URI
   } _prop;
 
+  bool _damaged; // true if player area should be repainted
+  struct
+  {
+    Rect rect;     // last reported rect
+    Color bgColor; // last reported background color
+    guint8 alpha;  // last reported alpha
+    bool visible;  // last reported visibility
+    bool focused;  // last reported focus state
+    bool debug;    // last reported debugging mode
+    int zindex;    // last reported z-index
+    int zorder;    // last reported z-order
+  } _damageState;
+
 protected:
   virtual bool doSetProperty (Property, const string &, const string &);
+  virtual bool isContentDamaged ();
+  virtual string getDebuggingInfo ();
+  virtual void redrawTexture ();
+  bool coversRect ();
 
 private:
+  void redrawSurface (cairo_t *);
   void redrawDebuggingInfo (cairo_t *);
 
   // Static.
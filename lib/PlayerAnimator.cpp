@@ -44,6 +44,12 @@ PlayerAnimator::clear ()
   _scheduled.clear ();
 }
 
+bool
+PlayerAnimator::isRunning ()
+{
+  return !_scheduled.empty ();
+}
+
 void
 PlayerAnimator::schedule (const string &name, const string &from,
                           const string &to, Time dur)
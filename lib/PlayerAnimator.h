@@ -87,6 +87,7 @@ public:
   PlayerAnimator (Formatter *, Time *);
   ~PlayerAnimator ();
   void clear ();
+  bool isRunning ();
   void schedule (const string &, const string &, const string &, Time);
   void update (Rect *, Color *, guint8 *, list<int> *);
   void setTransitionProperties (const string &, const string &);
@@ -21,29 +21,97 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
-// Creates a new surface by loading the image file at path PATH.  Stores the
-// resulting surface into *DUP and return CAIRO_STATUS_SUCCESS if
-// successful, or an error status otherwise.
+// Limits the size of the image being loaded by LOADER to the target size
+// in DATA, an array of two ints (width and height).  Non-positive target
+// dimensions are unconstrained; images are never scaled up.
+
+static void
+gdkx_pixbuf_size_prepared_cb (GdkPixbufLoader *loader, int width,
+                              int height, gpointer data)
+{
+  int *target = (int *) data;
+  int w, h;
+
+  w = (target[0] > 0) ? MIN (target[0], width) : width;
+  h = (target[1] > 0) ? MIN (target[1], height) : height;
+  if (w != width || h != height)
+    gdk_pixbuf_loader_set_size (loader, w, h);
+}
+
+// Creates a new pixbuf by loading the image in INPUT scaled down to at
+// most WIDTH x HEIGHT pixels.  The image is scaled while it is decoded, so
+// its full-resolution version is never held in memory.  Returns the new
+// pixbuf if successful, or null and sets ERROR otherwise.
+
+static GdkPixbuf *
+gdkx_pixbuf_new_from_stream_at_most (GInputStream *input, int width,
+                                     int height, GError **error)
+{
+  GdkPixbufLoader *loader;
+  GdkPixbuf *pixbuf;
+  guchar *buf;
+  gssize n;
+  int target[2];
+  bool ok;
+
+  target[0] = width;
+  target[1] = height;
+  loader = gdk_pixbuf_loader_new ();
+  g_assert_nonnull (loader);
+  g_signal_connect (loader, "size-prepared",
+                    G_CALLBACK (gdkx_pixbuf_size_prepared_cb), target);
+
+  buf = (guchar *) g_malloc (64 * 1024);
+  while ((n = g_input_stream_read (input, buf, 64 * 1024, NULL, error)) > 0)
+    if (unlikely (!gdk_pixbuf_loader_write (loader, buf, (gsize) n, error)))
+      break;
+  g_free (buf);
+
+  ok = (n == 0);
+  if (unlikely (!gdk_pixbuf_loader_close (loader, ok ? error : NULL)))
+    ok = false;
+
+  pixbuf = ok ? gdk_pixbuf_loader_get_pixbuf (loader) : NULL;
+  if (pixbuf != NULL)
+    g_object_ref (pixbuf);
+  else if (ok)
+    g_set_error_literal (error, GDK_PIXBUF_ERROR,
+                         GDK_PIXBUF_ERROR_CORRUPT_IMAGE, "Empty image");
+
+  g_object_unref (loader);
+  return pixbuf;
+}
+
+// Creates a new surface by loading the image file at path PATH, scaled
+// down to at most WIDTH x HEIGHT pixels (non-positive dimensions mean the
+// natural size).  Images without alpha channel are loaded into RGB24
+// surfaces whose unused byte is set to 0xff, so that they can be told
+// opaque and still be uploaded as BGRA textures.  Stores the resulting
+// surface into *DUP and return CAIRO_STATUS_SUCCESS if successful, or an
+// error status otherwise.
 
 static cairo_status_t
-cairox_surface_create_from_uri (const char *path, cairo_surface_t **dup)
+cairox_surface_create_from_uri (const char *path, int width, int height,
+                                cairo_surface_t **dup)
 {
   cairo_surface_t *sfc; // result
   GdkPixbuf *pixbuf;
   GError *error = NULL;
   cairo_t *cr;
   int w, h;
+  bool opaque;
 
   g_assert_nonnull (dup);
   GFile *file = g_file_new_for_uri (path);
   g_assert_nonnull (file);
 
   GFileInputStream *input = g_file_read (file, NULL, &error);
+  g_object_unref (file);
   g_assert_nonnull (input);
   if (input)
     {
-      pixbuf = gdk_pixbuf_new_from_stream (G_INPUT_STREAM (input), NULL,
-                                           &error);
+      pixbuf = gdkx_pixbuf_new_from_stream_at_most (
+          G_INPUT_STREAM (input), width, height, &error);
       g_object_unref (input);
     }
   else
@@ -63,7 +131,9 @@ cairox_surface_create_from_uri (const char *path, cairo_surface_t **dup)
 
   w = gdk_pixbuf_get_width (pixbuf);
   h = gdk_pixbuf_get_height (pixbuf);
-  sfc = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, w, h);
+  opaque = !gdk_pixbuf_get_has_alpha (pixbuf);
+  sfc = cairo_image_surface_create (
+      opaque ? CAIRO_FORMAT_RGB24 : CAIRO_FORMAT_ARGB32, w, h);
   g_assert_nonnull (sfc);
   if (unlikely (cairo_surface_status (sfc) != CAIRO_STATUS_SUCCESS))
     return cairo_surface_status (sfc);
@@ -80,46 +150,465 @@ cairox_surface_create_from_uri (const char *path, cairo_surface_t **dup)
   cairo_destroy (cr);
   g_object_unref (pixbuf);
 
+  if (opaque)
+    {
+      guchar *data;
+      int stride;
+
+      cairo_surface_flush (sfc);
+      data = cairo_image_surface_get_data (sfc);
+      stride = cairo_image_surface_get_stride (sfc);
+      for (int y = 0; y < h; y++)
+        {
+          guint32 *row = (guint32 *) (data + y * stride);
+          for (int x = 0; x < w; x++)
+            row[x] |= 0xff000000;
+        }
+      cairo_surface_mark_dirty (sfc);
+    }
+
   *dup = sfc;
   return CAIRO_STATUS_SUCCESS;
 }
 
+// Decoded-image cache.
+
+/**
+ * @brief Entry of the decoded-image cache.
+ *
+ * Entries are keyed by image URI and target size (0x0 stands for the
+ * natural size of the image).  Images are decoded directly at the target
+ * size, or at their natural size if that is smaller.  Each player showing
+ * the image holds a reference to its entry, and so does the worker
+ * decoding it.  Unreferenced entries stay resident, so that restarting an
+ * image or showing it in another media object costs nothing, until they
+ * are evicted in LRU order to keep the cache within budget.  Evictions
+ * happen only in the threads that acquire and release entries, never in
+ * the decoding workers.  Entries hold no OpenGL textures: these belong to
+ * the players, since players of different Ginga objects may draw to
+ * different GL contexts.  The key, URI and target size are constant; all
+ * other fields are protected by #image_cache_mutex.
+ */
+struct PlayerImageCacheEntry
+{
+  string key;               ///< Cache key.
+  string uri;               ///< Image URI.
+  int width;                ///< Target width (0 = natural width).
+  int height;               ///< Target height (0 = natural height).
+  cairo_surface_t *surface; ///< Decoded image (null until decoded).
+  cairo_status_t status;    ///< Decoding status.
+  bool done;                ///< Whether decoding has finished.
+  gsize bytes;              ///< Size of decoded image in bytes.
+  guint refs;               ///< Number of players using this entry.
+  list<PlayerImageCacheEntry *>::iterator lru; ///< Position in LRU list
+                                               ///< (valid if refs == 0).
+};
+
+static GMutex image_cache_mutex;
+static GCond image_cache_cond; // signaled when an image is decoded
+static GThreadPool *image_cache_pool = nullptr;
+static map<string, PlayerImageCacheEntry *> image_cache;
+static list<PlayerImageCacheEntry *> image_cache_lru; // unused, MRU first
+static gsize image_cache_budget = 32 * 1024 * 1024;
+static PlayerImageCacheStats image_cache_stats = { 0, 0, 0, 0, 0 };
+
+static string
+image_cache_key (const string &uri, int width, int height)
+{
+  return xstrbuild ("%s@%dx%d", uri.c_str (), width, height);
+}
+
+static void
+image_cache_free (PlayerImageCacheEntry *entry)
+{
+  if (entry->surface != nullptr)
+    cairo_surface_destroy (entry->surface);
+  delete entry;
+}
+
+// Evicts unused entries, least recently used first, until the cache fits
+// in BUDGET bytes.  Must be called with the cache mutex held.
+
+static void
+image_cache_trim_unlocked (gsize budget)
+{
+  while (image_cache_stats.bytes > budget && !image_cache_lru.empty ())
+    {
+      PlayerImageCacheEntry *entry = image_cache_lru.back ();
+      image_cache_lru.pop_back ();
+      image_cache.erase (entry->key);
+      image_cache_stats.bytes -= entry->bytes;
+      image_cache_stats.entries--;
+      image_cache_stats.evictions++;
+      TRACE ("evicting image %s (%" G_GSIZE_FORMAT " bytes)",
+             entry->key.c_str (), entry->bytes);
+      image_cache_free (entry);
+    }
+}
+
+// Drops a reference to cache ENTRY without evicting anything.  Must be
+// called with the cache mutex held.
+
+static void
+image_cache_release_unlocked (PlayerImageCacheEntry *entry)
+{
+  g_assert (entry->refs > 0);
+  if (--entry->refs == 0)
+    {
+      image_cache_lru.push_front (entry);
+      entry->lru = image_cache_lru.begin ();
+    }
+}
+
+// Drops a reference to cache ENTRY and evicts unused entries if the cache
+// is over budget.
+
+static void
+image_cache_release (PlayerImageCacheEntry *entry)
+{
+  g_mutex_lock (&image_cache_mutex);
+  image_cache_release_unlocked (entry);
+  image_cache_trim_unlocked (image_cache_budget);
+  g_mutex_unlock (&image_cache_mutex);
+}
+
+// Decodes the image of cache ENTRY and drops the reference held by the
+// decoder.  Doesn't evict anything: the cache may go over budget until the
+// next acquire or release.
+
+static void
+image_cache_decode (PlayerImageCacheEntry *entry)
+{
+  cairo_surface_t *sfc;
+  cairo_status_t status;
+  Time t0, dt;
+
+  t0 = (Time) g_get_monotonic_time () * GINGA_USECOND;
+  sfc = nullptr;
+  status = cairox_surface_create_from_uri (entry->uri.c_str (), entry->width,
+                                           entry->height, &sfc);
+  dt = (Time) g_get_monotonic_time () * GINGA_USECOND - t0;
+
+  g_mutex_lock (&image_cache_mutex);
+  entry->surface = sfc;
+  entry->status = status;
+  entry->done = true;
+  if (likely (status == CAIRO_STATUS_SUCCESS))
+    {
+      g_assert_nonnull (sfc);
+      entry->bytes = (gsize) cairo_image_surface_get_stride (sfc)
+                     * (gsize) cairo_image_surface_get_height (sfc);
+      image_cache_stats.bytes += entry->bytes;
+      TRACE ("decoded image %s (%dx%d) in %" GINGA_TIME_FORMAT,
+             entry->uri.c_str (), cairo_image_surface_get_width (sfc),
+             cairo_image_surface_get_height (sfc), GINGA_TIME_ARGS (dt));
+    }
+  g_cond_broadcast (&image_cache_cond);
+  image_cache_release_unlocked (entry);
+  g_mutex_unlock (&image_cache_mutex);
+}
+
+// Decodes the image of a cache entry in a worker thread, and then wakes
+// up the host so that the next tick finds the image decoded.
+
+static void
+image_cache_worker (gpointer data, unused (gpointer user_data))
+{
+  image_cache_decode ((PlayerImageCacheEntry *) data);
+  Formatter::wakeup ();
+}
+
+// Gets a reference to the cache entry of image file at URI scaled to
+// WIDTH x HEIGHT, starting to decode it if it is not resident: in a worker
+// thread if ASYNC is true, or in the calling thread otherwise.  In the
+// latter case, also waits for a decoding started by someone else to
+// finish.
+
+static PlayerImageCacheEntry *
+image_cache_acquire (const string &uri, int width, int height, bool async)
+{
+  PlayerImageCacheEntry *entry;
+  string key;
+
+  key = image_cache_key (uri, width, height);
+  g_mutex_lock (&image_cache_mutex);
+  image_cache_trim_unlocked (image_cache_budget);
+  auto it = image_cache.find (key);
+  if (it != image_cache.end ())
+    {
+      entry = it->second;
+      if (entry->refs++ == 0)
+        image_cache_lru.erase (entry->lru);
+      image_cache_stats.hits++;
+      if (!async)
+        while (!entry->done)
+          g_cond_wait (&image_cache_cond, &image_cache_mutex);
+      g_mutex_unlock (&image_cache_mutex);
+      return entry;
+    }
+  image_cache_stats.misses++;
+
+  entry = new PlayerImageCacheEntry;
+  entry->key = key;
+  entry->uri = uri;
+  entry->width = width;
+  entry->height = height;
+  entry->surface = nullptr;
+  entry->status = CAIRO_STATUS_SUCCESS;
+  entry->done = false;
+  entry->bytes = 0;
+  entry->refs = 2; // caller and decoder
+  image_cache[key] = entry;
+  image_cache_stats.entries++;
+
+  if (async && image_cache_pool == nullptr)
+    {
+      image_cache_pool = g_thread_pool_new (
+          image_cache_worker, nullptr, (gint) g_get_num_processors (),
+          FALSE, nullptr);
+      g_assert_nonnull (image_cache_pool);
+    }
+  g_mutex_unlock (&image_cache_mutex);
+
+  if (async)
+    g_thread_pool_push (image_cache_pool, entry, nullptr);
+  else
+    image_cache_decode (entry);
+
+  return entry;
+}
+
+// Returns true if the image of cache ENTRY has been decoded.
+
+static bool
+image_cache_is_done (PlayerImageCacheEntry *entry)
+{
+  bool done;
+
+  g_mutex_lock (&image_cache_mutex);
+  done = entry->done;
+  g_mutex_unlock (&image_cache_mutex);
+  return done;
+}
+
+// Returns true if cache ENTRY can be shown at WIDTH x HEIGHT, that is, if
+// its target size differs from WIDTH x HEIGHT by at most 1/4 in each
+// dimension.  The slack keeps resize animations from decoding the image
+// again at each frame.
+
+static bool
+image_cache_fits (PlayerImageCacheEntry *entry, int width, int height)
+{
+  if (width == 0 || height == 0 || entry->width == 0 || entry->height == 0)
+    return width == entry->width && height == entry->height;
+  return ABS (entry->width - width) * 4 <= width
+         && ABS (entry->height - height) * 4 <= height;
+}
+
+// Public.
+
 PlayerImage::PlayerImage (Formatter *formatter, Media *media)
     : Player (formatter, media)
 {
+  _staticSurface = true;
+  _entry = nullptr;
+  _next = nullptr;
 }
 
 PlayerImage::~PlayerImage ()
 {
+  if (_next != nullptr)
+    image_cache_release (_next);
+  this->releaseEntry ();
+}
+
+void
+PlayerImage::update ()
+{
+  bool animating = _animator->isRunning ();
+
+  Player::update ();
+
+  // Animations change the rect without dirtying the player, so once a
+  // size animation is over check whether the image must be decoded again
+  // at the final size.
+  if (animating && !_animator->isRunning () && _prop.visible
+      && _prop.rect.width > 0 && _prop.rect.height > 0)
+    {
+      this->reload ();
+    }
 }
 
 void
 PlayerImage::reload ()
 {
-  cairo_status_t status;
+  PlayerImageCacheEntry *want;
+  int width, height;
 
-  if (_surface != nullptr)
+  // Don't decode at the natural size before the player is laid out;
+  // stay dirty until it gets a size.
+  width = _prop.rect.width;
+  height = _prop.rect.height;
+  if (width <= 0 || height <= 0)
     {
-      cairo_surface_destroy (_surface);
-      if (_opengl && _gltexture)
-        GL::delete_texture (&_gltexture);
+      _dirty = true;
+      return;
     }
 
-  status = cairox_surface_create_from_uri (_prop.uri.c_str (), &_surface);
-  if (unlikely (status != CAIRO_STATUS_SUCCESS))
+  want = (_next != nullptr) ? _next : _entry;
+  if (want == nullptr || want->uri != _prop.uri
+      || !image_cache_fits (want, width, height))
     {
-      ERROR ("cannot load image file %s: %s", _prop.uri.c_str (),
-             cairo_status_to_string (status));
+      bool async = !_formatter->getOptionBool ("syncImageDecode");
+      if (_next != nullptr)
+        image_cache_release (_next);
+      _next = image_cache_acquire (_prop.uri, width, height, async);
     }
-  g_assert_nonnull (_surface);
 
-  if (_opengl)
-    GL::create_texture (&_gltexture,
-                        cairo_image_surface_get_width (_surface),
-                        cairo_image_surface_get_height (_surface),
-                        cairo_image_surface_get_data (_surface));
+  // Keep showing the current image (if any) until the next one is
+  // decoded; meanwhile, only the background is drawn.
+  if (_next != nullptr && image_cache_is_done (_next))
+    {
+      this->releaseEntry ();
+      _entry = _next;
+      _next = nullptr;
+      this->adoptEntry ();
+    }
 
   Player::reload ();
 }
 
+bool
+PlayerImage::isOpaque ()
+{
+  if (Player::isOpaque ())
+    return true;
+  return this->coversRect () && _surface != nullptr
+         && cairo_surface_get_content (_surface) == CAIRO_CONTENT_COLOR;
+}
+
+// Protected.
+
+bool
+PlayerImage::isContentDamaged ()
+{
+  if (_next != nullptr && image_cache_is_done (_next))
+    {
+      _dirty = true; // adopt decoded image on next redraw
+      return true;
+    }
+  return false;
+}
+
+// Public: Static.
+
+/**
+ * @brief Gets the counters of the decoded-image cache.
+ * @param[out] stats Variable to store the counters.
+ */
+void
+PlayerImage::getCacheStats (PlayerImageCacheStats *stats)
+{
+  g_assert_nonnull (stats);
+  g_mutex_lock (&image_cache_mutex);
+  *stats = image_cache_stats;
+  g_mutex_unlock (&image_cache_mutex);
+}
+
+/**
+ * @brief Gets the memory budget of the decoded-image cache.
+ * @return Budget in bytes.
+ */
+gsize
+PlayerImage::getCacheBudget ()
+{
+  gsize budget;
+  g_mutex_lock (&image_cache_mutex);
+  budget = image_cache_budget;
+  g_mutex_unlock (&image_cache_mutex);
+  return budget;
+}
+
+/**
+ * @brief Sets the memory budget of the decoded-image cache.
+ *
+ * Unused images are evicted, least recently used first, whenever the cache
+ * exceeds its budget.  Images in use are never evicted, so the cache may
+ * temporarily hold more than \p budget bytes.
+ *
+ * @param budget Budget in bytes.
+ */
+void
+PlayerImage::setCacheBudget (gsize budget)
+{
+  g_mutex_lock (&image_cache_mutex);
+  image_cache_budget = budget;
+  image_cache_trim_unlocked (budget);
+  g_mutex_unlock (&image_cache_mutex);
+}
+
+/**
+ * @brief Drops all unused images from the decoded-image cache and resets
+ * its hit, miss, and eviction counters.
+ */
+void
+PlayerImage::clearCache ()
+{
+  g_mutex_lock (&image_cache_mutex);
+  image_cache_trim_unlocked (0);
+  image_cache_stats.hits = 0;
+  image_cache_stats.misses = 0;
+  image_cache_stats.evictions = 0;
+  g_mutex_unlock (&image_cache_mutex);
+}
+
+// Private.
+
+// Takes the decoded image of current cache entry, creating the player's
+// own OpenGL texture for it if needed.
+void
+PlayerImage::adoptEntry ()
+{
+  g_assert_nonnull (_entry);
+  g_assert_null (_surface);
+
+  g_mutex_lock (&image_cache_mutex);
+  g_assert (_entry->done);
+  if (unlikely (_entry->status != CAIRO_STATUS_SUCCESS))
+    {
+      ERROR ("cannot load image file %s: %s", _entry->uri.c_str (),
+             cairo_status_to_string (_entry->status));
+    }
+  g_assert_nonnull (_entry->surface);
+  _surface = cairo_surface_reference (_entry->surface);
+  g_mutex_unlock (&image_cache_mutex);
+
+  if (_opengl)
+    {
+      g_assert (_gltexture == 0);
+      GL::create_texture (&_gltexture,
+                          cairo_image_surface_get_width (_surface),
+                          cairo_image_surface_get_height (_surface),
+                          cairo_image_surface_get_data (_surface));
+    }
+}
+
+void
+PlayerImage::releaseEntry ()
+{
+  if (_entry == nullptr)
+    return;
+
+  // The surface belongs to the cache entry; the texture, to the player.
+  if (_surface != nullptr)
+    {
+      cairo_surface_destroy (_surface);
+      _surface = nullptr;
+    }
+  if (_gltexture)
+    GL::delete_texture (&_gltexture);
+  image_cache_release (_entry);
+  _entry = nullptr;
+}
+
 GINGA_NAMESPACE_END
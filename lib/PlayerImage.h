@@ -22,12 +22,44 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
+/**
+ * @brief Decoded-image cache counters.
+ *
+ * Counters of the process-wide cache shared by all image players.
+ */
+typedef struct PlayerImageCacheStats
+{
+  guint hits;      ///< Lookups satisfied by a resident image.
+  guint misses;    ///< Lookups that had to decode the image file.
+  guint evictions; ///< Images dropped to stay within the memory budget.
+  gsize bytes;     ///< Bytes held by resident decoded images.
+  guint entries;   ///< Number of resident images.
+} PlayerImageCacheStats;
+
+struct PlayerImageCacheEntry;
+
 class PlayerImage : public Player
 {
 public:
   PlayerImage (Formatter *, Media *);
   ~PlayerImage ();
+  void update () override;
   void reload () override;
+  bool isOpaque () override;
+
+  static void getCacheStats (PlayerImageCacheStats *);
+  static gsize getCacheBudget ();
+  static void setCacheBudget (gsize);
+  static void clearCache ();
+
+protected:
+  bool isContentDamaged () override;
+
+private:
+  PlayerImageCacheEntry *_entry; ///< Cache entry of current image.
+  PlayerImageCacheEntry *_next;  ///< Cache entry of image being decoded.
+  void adoptEntry ();
+  void releaseEntry ();
 };
 
 GINGA_NAMESPACE_END
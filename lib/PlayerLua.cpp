@@ -37,6 +37,51 @@ GINGA_NAMESPACE_BEGIN
 
 #define evt_key_send ncluaw_send_key_event
 
+// Name of the attribution event used by scripts to report wake-ups.
+#define PLAYER_LUA_WAKEUP "ginga.wakeup"
+
+// Name of the attribution event used by scripts to report canvas flushes.
+#define PLAYER_LUA_FLUSH "ginga.flush"
+
+// Script run in place of the NCLua script.  It wraps event.timer() and
+// event.post() so that the player is told when the script next needs to
+// be cycled, and canvas:flush() so that the player is told when the
+// script has drawn something; then it runs the actual script.  If flushes
+// cannot be hooked, the player damages its rect after every cycle.
+#define PLAYER_LUA_PRELUDE "\
+local post, timer = event.post, event.timer\n\
+local function notify (name, value)\n\
+  post ('out', {class='ncl', type='attribution', action='start',\n\
+                name=name, value=value})\n\
+end\n\
+local function wakeup (ms)\n\
+  notify ('" PLAYER_LUA_WAKEUP "', tostring (ms))\n\
+end\n\
+local mt = canvas and getmetatable (canvas)\n\
+local methods = type (mt) == 'table' and mt.__index\n\
+if type (methods) == 'table' and type (methods.flush) == 'function' then\n\
+  local flush = methods.flush\n\
+  methods.flush = function (...)\n\
+    notify ('" PLAYER_LUA_FLUSH "', '')\n\
+    return flush (...)\n\
+  end\n\
+  notify ('" PLAYER_LUA_FLUSH "', 'hooked')\n\
+end\n\
+event.timer = function (ms, f)\n\
+  wakeup (ms + 1) -- one millisecond of slack for clock rounding\n\
+  return timer (ms, f)\n\
+end\n\
+event.post = function (dst, evt)\n\
+  if evt == nil then\n\
+    return post (dst)\n\
+  end\n\
+  if dst == 'in' then\n\
+    wakeup (0)\n\
+  end\n\
+  return post (dst, evt)\n\
+end\n\
+return dofile ([==[%s]==])\n"
+
 /// Conversion from NCLua actions to NCL transitions
 static map<string, Event::Transition> nclua_act_to_ncl = {
   { "start", Event::START },   { "pause", Event::PAUSE },
@@ -51,6 +96,8 @@ PlayerLua::PlayerLua (Formatter *formatter, Media *media)
 {
   _nw = NULL;
   _init_rect = { 0, 0, 0, 0 };
+  _wakeup = GINGA_TIME_NONE;
+  _hooked = false;
 }
 
 PlayerLua::~PlayerLua ()
@@ -61,10 +108,12 @@ void
 PlayerLua::start ()
 {
   char *errmsg;
+  gchar *prelude;
+  gint fd;
 
   g_assert (_state != OCCURRING);
   g_assert_null (_nw);
-  GError *err;
+  GError *err = nullptr;
   char *filename = g_filename_from_uri (_prop.uri.c_str (), NULL, &err);
   if (filename == NULL)
     {
@@ -72,10 +121,22 @@ PlayerLua::start ()
       g_error_free (err);
     }
 
+  fd = g_file_open_tmp ("ginga-nclua-XXXXXX.lua", &prelude, &err);
+  if (unlikely (fd < 0))
+    {
+      ERROR ("cannot create NCLua prelude: %s", err->message);
+      g_error_free (err);
+    }
+  g_close (fd, nullptr);
+  g_assert (g_file_set_contents (
+      prelude, xstrbuild (PLAYER_LUA_PRELUDE, filename).c_str (), -1, nullptr));
+
   this->pwdSave (filename);
   _init_rect = _prop.rect;
-  _nw = ncluaw_open (filename, _init_rect.width, _init_rect.height,
+  _nw = ncluaw_open (prelude, _init_rect.width, _init_rect.height,
                      &errmsg);
+  g_remove (prelude);
+  g_free (prelude);
   g_free (filename);
 
   if (unlikely (_nw == nullptr))
@@ -83,7 +144,10 @@ PlayerLua::start ()
   this->pwdRestore ();
 
   evt_ncl_send_presentation (_nw, "start", "");
+  _wakeup = GINGA_TIME_NONE;
+  _hooked = false;
   Player::start ();
+  this->wakeup (0);
 }
 
 void
@@ -127,6 +191,7 @@ PlayerLua::sendKeyEvent (const string &key, bool press)
 {
   g_assert_nonnull (_nw);
   evt_key_send (_nw, press ? "press" : "release", key.c_str ());
+  this->wakeup (0);
 }
 
 void
@@ -134,46 +199,26 @@ PlayerLua::sendPresentationEvent (const string &action, const string &label)
 {
   g_assert_nonnull (_nw);
   evt_ncl_send_presentation (_nw, action.c_str (), label.c_str ());
+  this->wakeup (0);
 }
 
 void
-PlayerLua::redraw (cairo_t *cr)
+PlayerLua::update ()
 {
-  cairo_surface_t *sfc;
   ncluaw_event_t *evt;
 
   g_assert (_state != SLEEPING);
   g_assert_nonnull (_nw);
 
+  Player::update ();
+
+  if (_wakeup != GINGA_TIME_NONE && _wakeup <= _time)
+    _wakeup = GINGA_TIME_NONE; // due; the script will report the next one
+
   this->pwdSave ();
   ncluaw_cycle (_nw);
   this->pwdRestore ();
 
-  sfc = (cairo_surface_t *) ncluaw_debug_get_surface (_nw);
-  g_assert_nonnull (sfc);
-
-  if (_opengl)
-    {
-      if (_gltexture == 0)
-        GL::create_texture (&_gltexture,
-                            cairo_image_surface_get_width (sfc),
-                            cairo_image_surface_get_height (sfc),
-                            cairo_image_surface_get_data (sfc));
-      else
-        GL::update_subtexture (_gltexture, 0, 0,
-                               cairo_image_surface_get_width (sfc),
-                               cairo_image_surface_get_height (sfc),
-                               cairo_image_surface_get_data (sfc));
-    }
-  else
-    {
-      _surface = sfc;
-    }
-
-  Player::redraw (cr);
-  if (!_opengl)
-    _surface = nullptr;
-
   // Get events posted from NCLua.
   while ((evt = ncluaw_receive (_nw)) != nullptr)
     {
@@ -183,7 +228,20 @@ PlayerLua::redraw (cairo_t *cr)
           continue; // nothing to do
         }
 
-      if (g_str_equal (evt->u.ncl.type, "presentation"))
+      if (g_str_equal (evt->u.ncl.type, "attribution")
+          && g_str_equal (evt->u.ncl.name, PLAYER_LUA_WAKEUP))
+        {
+          double ms = g_ascii_strtod (evt->u.ncl.value, nullptr);
+          this->wakeup ((Time) (MAX (ms, 0.) * (double) GINGA_MSECOND));
+        }
+      else if (g_str_equal (evt->u.ncl.type, "attribution")
+               && g_str_equal (evt->u.ncl.name, PLAYER_LUA_FLUSH))
+        {
+          if (g_str_equal (evt->u.ncl.value, "hooked"))
+            _hooked = true;
+          this->damage ();
+        }
+      else if (g_str_equal (evt->u.ncl.type, "presentation"))
         {
           Event *nclEvt;
           std::string label = evt->u.ncl.name;
@@ -212,6 +270,61 @@ PlayerLua::redraw (cairo_t *cr)
     }
 }
 
+void
+PlayerLua::redraw (cairo_t *cr)
+{
+  cairo_surface_t *sfc;
+
+  g_assert (_state != SLEEPING);
+  g_assert_nonnull (_nw);
+
+  sfc = (cairo_surface_t *) ncluaw_debug_get_surface (_nw);
+  g_assert_nonnull (sfc);
+
+  if (_opengl)
+    {
+      if (_gltexture == 0)
+        GL::create_texture (&_gltexture,
+                            cairo_image_surface_get_width (sfc),
+                            cairo_image_surface_get_height (sfc),
+                            cairo_image_surface_get_data (sfc));
+      else
+        GL::update_subtexture (_gltexture, 0, 0,
+                               cairo_image_surface_get_width (sfc),
+                               cairo_image_surface_get_height (sfc),
+                               cairo_image_surface_get_data (sfc));
+    }
+  else
+    {
+      _surface = sfc;
+    }
+
+  Player::redraw (cr);
+  if (!_opengl)
+    _surface = nullptr;
+}
+
+// The script is cycled when it is due to wake up, i.e., when one of its
+// timers expires, when it posts an event to itself, or when an event is
+// sent to it.  Scripts can also wait on things the player cannot see
+// (e.g., TCP connections), so they are cycled at least every
+// PLAYER_LUA_IDLE_INTERVAL.
+Time
+PlayerLua::getTimeToNextDeadline ()
+{
+  Time deadline;
+  Time wait;
+
+  deadline = Player::getTimeToNextDeadline ();
+  if (_state != OCCURRING)
+    return deadline;
+
+  wait = PLAYER_LUA_IDLE_INTERVAL;
+  if (_wakeup != GINGA_TIME_NONE)
+    wait = (_wakeup > _time) ? MIN (_wakeup - _time, wait) : 0;
+  return MIN (deadline, wait);
+}
+
 // Protected.
 
 bool
@@ -224,12 +337,31 @@ PlayerLua::doSetProperty (Property code, const string &name,
       const char *v = value.c_str ();
       evt_ncl_send_attribution (_nw, "start", k, v);
       evt_ncl_send_attribution (_nw, "stop", k, v);
+      this->wakeup (0);
     }
   return Player::doSetProperty (code, name, value);
 }
 
+// Canvas flushes damage the player as they are reported; only if they
+// cannot be hooked may the NCLua surface change at each cycle.
+bool
+PlayerLua::isContentDamaged ()
+{
+  return !_hooked;
+}
+
 // Private.
 
+// Schedules a cycle of the script DELAY from now.  The earliest scheduled
+// cycle wins.
+void
+PlayerLua::wakeup (Time delay)
+{
+  Time when = _time + delay;
+  if (_wakeup == GINGA_TIME_NONE || when < _wakeup)
+    _wakeup = when;
+}
+
 static void
 do_chdir (string dir)
 {
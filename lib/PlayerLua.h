@@ -26,6 +26,9 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
+/// Longest time an occurring NCLua script goes without being cycled.
+#define PLAYER_LUA_IDLE_INTERVAL (100 * GINGA_MSECOND)
+
 class PlayerLua : public Player
 {
 public:
@@ -35,23 +38,29 @@ public:
   void stop () override;
   void pause () override;
   void resume () override;
+  void update () override;
   void redraw (cairo_t *) override;
+  Time getTimeToNextDeadline () override;
   void sendKeyEvent (const string &, bool) override;
   void sendPresentationEvent (const string &, const string &) override;
 
 protected:
   virtual bool doSetProperty (Property, const string &,
                               const string &) override;
+  bool isContentDamaged () override;
 
 private:
   ncluaw_t *_nw;     // the NCLua state
   Rect _init_rect;   // initial output rectangle
   string _pwd;       // script's working dir
   string _saved_pwd; // saved working dir
+  Time _wakeup;      // playback time of next scheduled cycle
+  bool _hooked;      // whether the script reports canvas flushes
 
   void pwdSave (const string &);
   void pwdSave ();
   void pwdRestore ();
+  void wakeup (Time);
 };
 
 GINGA_NAMESPACE_END
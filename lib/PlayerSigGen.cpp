@@ -243,7 +243,7 @@ PlayerSigGen::resume ()
 }
 
 void
-PlayerSigGen::redraw (cairo_t *cr)
+PlayerSigGen::update ()
 {
   GstSample *sample;
   GstVideoFrame v_frame;
@@ -259,16 +259,17 @@ PlayerSigGen::redraw (cairo_t *cr)
   cairo_status_t status;
 
   g_assert (_state != SLEEPING);
+  Player::update ();
 
   if (Player::getEOS ())
-    goto done;
+    return;
 
   if (!g_atomic_int_compare_and_exchange (&_sample_flag, 1, 0))
-    goto done;
+    return;
 
   sample = gst_app_sink_pull_sample (GST_APP_SINK (_audio.videoSink));
   if (sample == nullptr)
-    goto done;
+    return;
 
   buf = gst_sample_get_buffer (sample);
   g_assert_nonnull (buf);
@@ -307,9 +308,14 @@ PlayerSigGen::redraw (cairo_t *cr)
           (cairo_destroy_func_t) gst_sample_unref);
       g_assert (status == CAIRO_STATUS_SUCCESS);
     }
+}
 
-done:
-  Player::redraw (cr);
+Time
+PlayerSigGen::getTimeToNextDeadline ()
+{
+  if (_state == OCCURRING)
+    return 0; // EOS arrives asynchronously
+  return Player::getTimeToNextDeadline ();
 }
 
 // Protected.
@@ -31,7 +31,8 @@ public:
   void stop () override;
   void pause () override;
   void resume () override;
-  void redraw (cairo_t *) override;
+  void update () override;
+  Time getTimeToNextDeadline () override;
 
 protected:
   bool doSetProperty (Property, const string &, const string &) override;
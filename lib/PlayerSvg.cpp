@@ -27,6 +27,7 @@ GINGA_NAMESPACE_BEGIN
 PlayerSvg::PlayerSvg (Formatter *formatter, Media *media)
     : Player (formatter, media)
 {
+  _staticSurface = true;
 }
 
 PlayerSvg::~PlayerSvg ()
@@ -152,6 +152,8 @@ PlayerText::renderSurface (const string &text, const string &family,
 PlayerText::PlayerText (Formatter *formatter, Media *media)
     : Player (formatter, media)
 {
+  _staticSurface = true;
+
   // Initialize handled properties.
   static set<string> handled = {
     "fontColor",   "bgColor",    "fontFamily", "fontSize",  "fontStyle",
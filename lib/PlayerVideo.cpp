@@ -39,6 +39,159 @@ GINGA_NAMESPACE_BEGIN
   }                                                                        \
   G_STMT_END
 
+// Video caps accepted in OpenGL mode; OpenGL ES 2 has no two-channel
+// textures, hence no NV12.
+#if defined WITH_OPENGLES2 && WITH_OPENGLES2
+#define PLAYER_VIDEO_GL_CAPS "video/x-raw,format=(string){I420,BGRA}"
+#else
+#define PLAYER_VIDEO_GL_CAPS "video/x-raw,format=(string){I420,NV12,BGRA}"
+#endif
+
+// Playbin flag GST_PLAY_FLAG_NATIVE_VIDEO, which is not exported by
+// GStreamer headers: stops playsink from converting video before the sink.
+#define PLAYER_VIDEO_PLAY_FLAG_NATIVE_VIDEO (1 << 6)
+
+// Returns the running time of SAMPLE, or GINGA_TIME_NONE if unknown.
+static Time
+sample_get_running_time (GstSample *sample)
+{
+  GstBuffer *buf;
+  const GstSegment *segment;
+
+  buf = gst_sample_get_buffer (sample);
+  segment = gst_sample_get_segment (sample);
+  if (buf == nullptr || segment == nullptr || !GST_BUFFER_PTS_IS_VALID (buf))
+    return GINGA_TIME_NONE;
+
+  return gst_segment_to_running_time (segment, GST_FORMAT_TIME,
+                                      GST_BUFFER_PTS (buf));
+}
+
+// Frame queue.
+
+PlayerVideoQueue::PlayerVideoQueue ()
+{
+  _head = 0;
+  _tail = 0;
+  _dropped = 0;
+  _presented = 0;
+  _late = 0;
+  _repeated = 0;
+}
+
+PlayerVideoQueue::~PlayerVideoQueue ()
+{
+  this->flush ();
+}
+
+// Returns true if no frame is queued.  Can be called by either side.
+bool
+PlayerVideoQueue::isEmpty ()
+{
+  return g_atomic_int_get (&_head) == g_atomic_int_get (&_tail);
+}
+
+// Producer side: queues SAMPLE, taking ownership of it.  If the queue is
+// full, drops SAMPLE and returns false.  Only the producer writes head.
+bool
+PlayerVideoQueue::push (GstSample *sample)
+{
+  gint head, tail;
+
+  g_assert_nonnull (sample);
+  head = g_atomic_int_get (&_head);
+  tail = g_atomic_int_get (&_tail);
+  if (unlikely ((guint) (head - tail) >= PLAYER_VIDEO_QUEUE_SIZE))
+    {
+      gst_sample_unref (sample);
+      g_atomic_int_inc (&_dropped);
+      return false;
+    }
+
+  _ring[(guint) head % PLAYER_VIDEO_QUEUE_SIZE] = sample;
+  g_atomic_int_set (&_head, head + 1);
+  return true;
+}
+
+// Consumer side: pops the latest frame that is due at running time NOW,
+// dropping the older due frames, and returns it; the caller owns the
+// returned sample.  If NOW is GINGA_TIME_NONE, every queued frame is due.
+// Returns null if no queued frame is due yet; in this case, the frame
+// presented last is repeated.  Only the consumer writes tail.
+GstSample *
+PlayerVideoQueue::pop (Time now)
+{
+  GstSample *best;
+  Time rt, best_rt;
+  gint head, tail;
+
+  best = nullptr;
+  best_rt = GINGA_TIME_NONE;
+
+  head = g_atomic_int_get (&_head);
+  tail = g_atomic_int_get (&_tail);
+  while (tail != head)
+    {
+      GstSample *sample = _ring[(guint) tail % PLAYER_VIDEO_QUEUE_SIZE];
+      rt = sample_get_running_time (sample);
+      if (GINGA_TIME_IS_VALID (now) && GINGA_TIME_IS_VALID (rt) && rt > now)
+        break; // not due yet
+
+      if (best != nullptr)
+        {
+          gst_sample_unref (best);
+          g_atomic_int_inc (&_dropped);
+        }
+      best = sample;
+      best_rt = rt;
+      tail++;
+      g_atomic_int_set (&_tail, tail);
+    }
+
+  if (best == nullptr)
+    {
+      if (_presented > 0)
+        _repeated++;
+      return nullptr;
+    }
+
+  _presented++;
+  if (GINGA_TIME_IS_VALID (now) && GINGA_TIME_IS_VALID (best_rt)
+      && now - best_rt > PLAYER_VIDEO_LATE_THRESHOLD)
+    {
+      _late++;
+    }
+
+  return best;
+}
+
+// Consumer side: drops all queued frames.
+void
+PlayerVideoQueue::flush ()
+{
+  gint head, tail;
+
+  head = g_atomic_int_get (&_head);
+  tail = g_atomic_int_get (&_tail);
+  while (tail != head)
+    {
+      gst_sample_unref (_ring[(guint) tail % PLAYER_VIDEO_QUEUE_SIZE]);
+      tail++;
+    }
+  g_atomic_int_set (&_tail, tail);
+}
+
+// Gets the queue counters.  Called by the consumer.
+void
+PlayerVideoQueue::getStats (PlayerVideoQueueStats *stats)
+{
+  g_assert_nonnull (stats);
+  stats->presented = _presented;
+  stats->dropped = (guint) g_atomic_int_get (&_dropped);
+  stats->late = _late;
+  stats->repeated = _repeated;
+}
+
 // Public.
 
 PlayerVideo::PlayerVideo (Formatter *formatter, Media *media)
@@ -57,8 +210,25 @@ PlayerVideo::PlayerVideo (Formatter *formatter, Media *media)
   _audio.convert = nullptr;
   _audio.sink = nullptr;
   _video.bin = nullptr;
+  _video.scale = nullptr;
+  _video.convert = nullptr;
   _video.caps = nullptr;
   _video.sink = nullptr;
+  _video.width = 0;
+  _video.height = 0;
+  _upload.format = GST_VIDEO_FORMAT_UNKNOWN;
+  _upload.width = 0;
+  _upload.height = 0;
+  _upload.planes[0] = _upload.planes[1] = _upload.planes[2] = 0;
+  _upload.bt709 = false;
+  _upload.last = 0;
+  _upload.total = 0;
+  _upload.frames = 0;
+  _frames.width = 0;
+  _frames.height = 0;
+  _decode.hidden = false;
+  _decode.resync = false;
+  _decode.skipped = 0;
 
   if (!gst_is_initialized ())
     {
@@ -128,6 +298,25 @@ PlayerVideo::PlayerVideo (Formatter *formatter, Media *media)
   _video.bin = gst_bin_new ("video.bin");
   g_assert_nonnull (_video.bin);
 
+  // The scaler is optional; see PlayerVideo::updateScale().  It must come
+  // before the color conversion, so playsink is told to leave frames in
+  // their native format and the bin does its own conversion.
+  if (_formatter->getOptionBool ("scaleVideo"))
+    {
+      guint flags;
+
+      _video.scale = gst_element_factory_make ("videoscale", "video.scale");
+      g_assert_nonnull (_video.scale);
+
+      _video.convert
+          = gst_element_factory_make ("videoconvert", "video.convert");
+      g_assert_nonnull (_video.convert);
+
+      g_object_get (G_OBJECT (_playbin), "flags", &flags, nullptr);
+      g_object_set (G_OBJECT (_playbin), "flags",
+                    flags | PLAYER_VIDEO_PLAY_FLAG_NATIVE_VIDEO, nullptr);
+    }
+
   _video.caps = gst_element_factory_make ("capsfilter", "video.filter");
   g_assert_nonnull (_video.caps);
 
@@ -143,8 +332,16 @@ PlayerVideo::PlayerVideo (Formatter *formatter, Media *media)
   g_assert (gst_bin_add (GST_BIN (_video.bin), _video.caps));
   g_assert (gst_bin_add (GST_BIN (_video.bin), _video.sink));
   g_assert (gst_element_link (_video.caps, _video.sink));
+  if (_video.scale != nullptr)
+    {
+      g_assert (gst_bin_add (GST_BIN (_video.bin), _video.scale));
+      g_assert (gst_bin_add (GST_BIN (_video.bin), _video.convert));
+      g_assert (gst_element_link (_video.scale, _video.convert));
+      g_assert (gst_element_link (_video.convert, _video.caps));
+    }
 
-  pad = gst_element_get_static_pad (_video.caps, "sink");
+  pad = gst_element_get_static_pad (
+      (_video.scale != nullptr) ? _video.scale : _video.caps, "sink");
   g_assert_nonnull (pad);
   ghost = gst_ghost_pad_new ("sink", pad);
   g_assert_nonnull (ghost);
@@ -161,6 +358,8 @@ PlayerVideo::PlayerVideo (Formatter *formatter, Media *media)
 
   g_signal_connect (G_OBJECT (_playbin), "about-to-finish", (GCallback) cb_EOS,
                     this);
+  g_signal_connect (G_OBJECT (_playbin), "element-added",
+                    (GCallback) cb_ElementAdded, this);
 
   // Initialize some handled properties.
   static set<string> handled = { "balance", "bass",   "freeze", "mute",
@@ -172,28 +371,28 @@ PlayerVideo::PlayerVideo (Formatter *formatter, Media *media)
 
 PlayerVideo::~PlayerVideo ()
 {
+  if (_opengl)
+    this->deleteTextures ();
 }
 
 void
 PlayerVideo::start ()
 {
   GstCaps *caps;
-  GstStructure *st;
   GstStateChangeReturn ret;
 
   g_assert (_state != OCCURRING);
   TRACE ("starting %s", _id.c_str ());
 
-  st = gst_structure_new_empty ("video/x-raw");
-  gst_structure_set (st, "format", G_TYPE_STRING, "BGRA", nullptr);
-
-  caps = gst_caps_new_full (st, nullptr);
-  g_assert_nonnull (caps);
+  _video.width = 0;
+  _video.height = 0;
+  caps = this->createCaps (0, 0);
   g_object_set (_video.caps, "caps", caps, nullptr);
   gst_caps_unref (caps);
 
   Player::setEOS (false);
-  g_atomic_int_set (&_sample_flag, 0);
+  _queue.flush ();
+  _decode.resync = false;
 
   g_object_set (_audio.volume, "volume", _prop.volume, "mute", _prop.mute,
                 nullptr);
@@ -220,6 +419,7 @@ PlayerVideo::stop ()
   gst_object_unref (_playbin);
   _playbin = nullptr;
   _stack_actions.clear ();
+  _queue.flush ();
   Player::stop ();
 }
 
@@ -257,6 +457,7 @@ PlayerVideo::seek (gint64 value)
                                    value, GST_SEEK_TYPE_NONE,
                                    (gint64) GST_CLOCK_TIME_NONE)))
     TRACE ("seek failed");
+  _queue.flush ();
 
   ret = gst_element_get_state (_playbin, &curr, &pending,
                                GST_CLOCK_TIME_NONE);
@@ -293,10 +494,113 @@ PlayerVideo::speed (double value)
   if (unlikely (!gst_element_send_event (_video.sink, seek_event)))
     TRACE ("speed failed");
   gst_event_unref (seek_event);
+  _queue.flush ();
+}
+
+// Besides the usual properties, reports the frame queue counters:
+// framesPresented, framesDropped (skipped, or discarded because the queue
+// was full), framesLate (presented too late), framesRepeated (updates that
+// presented no new frame), framesSkipped (not decoded while hidden), and
+// frameWidth and frameHeight (size of the last frame presented).
+// With scaleVideo, also reports convertFormat, convertWidth and
+// convertHeight (caps negotiated upstream of the color conversion).
+// In OpenGL mode, also reports the texture upload counters: framesUploaded,
+// uploadFormat (format of the last frame uploaded), uploadTime and
+// uploadTimeAverage (time spent uploading the last frame and the average
+// per frame, in nanoseconds).
+string
+PlayerVideo::getProperty (const string &name)
+{
+  PlayerVideoQueueStats stats;
+
+  _queue.getStats (&stats);
+  if (name == "framesPresented")
+    return xstrbuild ("%" G_GUINT64_FORMAT, stats.presented);
+  if (name == "framesDropped")
+    return xstrbuild ("%u", stats.dropped);
+  if (name == "framesLate")
+    return xstrbuild ("%" G_GUINT64_FORMAT, stats.late);
+  if (name == "framesRepeated")
+    return xstrbuild ("%" G_GUINT64_FORMAT, stats.repeated);
+  if (name == "framesSkipped")
+    return xstrbuild ("%d", g_atomic_int_get (&_decode.skipped));
+  if (name == "frameWidth")
+    return xstrbuild ("%d", _frames.width);
+  if (name == "frameHeight")
+    return xstrbuild ("%d", _frames.height);
+  if (name == "convertFormat" || name == "convertWidth"
+      || name == "convertHeight")
+    {
+      GstVideoInfo info;
+      GstCaps *caps;
+      GstPad *pad;
+      string value = "";
+
+      if (_video.convert == nullptr)
+        return "";
+
+      pad = gst_element_get_static_pad (_video.convert, "sink");
+      g_assert_nonnull (pad);
+      caps = gst_pad_get_current_caps (pad);
+      gst_object_unref (pad);
+      if (caps == nullptr)
+        return ""; // not negotiated yet
+
+      if (gst_video_info_from_caps (&info, caps))
+        {
+          if (name == "convertFormat")
+            value = GST_VIDEO_INFO_NAME (&info);
+          else if (name == "convertWidth")
+            value = xstrbuild ("%d", GST_VIDEO_INFO_WIDTH (&info));
+          else
+            value = xstrbuild ("%d", GST_VIDEO_INFO_HEIGHT (&info));
+        }
+      gst_caps_unref (caps);
+      return value;
+    }
+  if (name == "framesUploaded")
+    return xstrbuild ("%" G_GUINT64_FORMAT, _upload.frames);
+  if (name == "uploadFormat")
+    return (_upload.frames > 0)
+               ? gst_video_format_to_string (_upload.format)
+               : "";
+  if (name == "uploadTime")
+    return xstrbuild ("%" G_GUINT64_FORMAT, _upload.last);
+  if (name == "uploadTimeAverage")
+    return xstrbuild ("%" G_GUINT64_FORMAT,
+                      (_upload.frames > 0) ? _upload.total / _upload.frames
+                                           : 0);
+  return Player::getProperty (name);
+}
+
+// Video frames carry no alpha, so once a frame is shown the player is
+// opaque whatever its background.
+bool
+PlayerVideo::isOpaque ()
+{
+  PlayerVideoQueueStats stats;
+
+  if (Player::isOpaque ())
+    return true;
+  _queue.getStats (&stats);
+  return this->coversRect () && stats.presented > 0;
 }
 
+// While the player is hidden from screen, encoded video frames are dropped
+// before reaching the decoder; decoding resumes on the next keyframe after
+// the player becomes visible again.  Audio is not affected.
 void
-PlayerVideo::redraw (cairo_t *cr)
+PlayerVideo::setHidden (bool hidden)
+{
+  if (hidden != _hidden)
+    TRACE ("%s video decoding of %s", hidden ? "suspending" : "resuming",
+           _id.c_str ());
+  Player::setHidden (hidden);
+  g_atomic_int_set (&_decode.hidden, hidden);
+}
+
+void
+PlayerVideo::update ()
 {
   GstSample *sample;
   GstVideoFrame v_frame;
@@ -312,16 +616,15 @@ PlayerVideo::redraw (cairo_t *cr)
   cairo_status_t status;
 
   g_assert (_state != SLEEPING);
+  Player::update ();
 
   if (Player::getEOS ())
-    goto done;
-
-  if (!g_atomic_int_compare_and_exchange (&_sample_flag, 1, 0))
-    goto done;
+    return;
 
-  sample = gst_app_sink_pull_sample (GST_APP_SINK (_video.sink));
+  this->updateScale ();
+  sample = _queue.pop (this->getRunningTime ());
   if (sample == nullptr)
-    goto done;
+    return;
 
   buf = gst_sample_get_buffer (sample);
   g_assert_nonnull (buf);
@@ -336,13 +639,12 @@ PlayerVideo::redraw (cairo_t *cr)
   width = GST_VIDEO_FRAME_WIDTH (&v_frame);
   height = GST_VIDEO_FRAME_HEIGHT (&v_frame);
   stride = (int) GST_VIDEO_FRAME_PLANE_STRIDE (&v_frame, 0);
+  _frames.width = width;
+  _frames.height = height;
 
   if (_opengl)
     {
-      if (_gltexture)
-        GL::delete_texture (&_gltexture);
-      // FIXME: Do not create a new texture for each frame.
-      GL::create_texture (&_gltexture, width, height, pixels);
+      this->uploadFrame (&v_frame);
       gst_video_frame_unmap (&v_frame);
       gst_sample_unref (sample);
     }
@@ -360,9 +662,6 @@ PlayerVideo::redraw (cairo_t *cr)
           (cairo_destroy_func_t) gst_sample_unref);
       g_assert (status == CAIRO_STATUS_SUCCESS);
     }
-
-done:
-  Player::redraw (cr);
 }
 
 gint64
@@ -392,6 +691,14 @@ PlayerVideo::getStreamMediaDuration ()
   return dur;
 }
 
+Time
+PlayerVideo::getTimeToNextDeadline ()
+{
+  if (_state == OCCURRING)
+    return 0; // frames and EOS arrive asynchronously
+  return Player::getTimeToNextDeadline ();
+}
+
 // Protected.
 
 bool
@@ -511,6 +818,63 @@ PlayerVideo::doSetProperty (Property code, unused (const string &name),
   return true;
 }
 
+bool
+PlayerVideo::isContentDamaged ()
+{
+  return !_queue.isEmpty ();
+}
+
+string
+PlayerVideo::getDebuggingInfo ()
+{
+  PlayerVideoQueueStats stats;
+  string str;
+
+  _queue.getStats (&stats);
+  str = xstrbuild ("frames:%" G_GUINT64_FORMAT " drop:%u"
+                   " late:%" G_GUINT64_FORMAT " rep:%" G_GUINT64_FORMAT
+                   " skip:%d",
+                   stats.presented, stats.dropped, stats.late,
+                   stats.repeated,
+                   g_atomic_int_get (&_decode.skipped));
+  if (_opengl && _upload.frames > 0)
+    str += xstrbuild ("\n%s %dx%d upload:%.2fms avg:%.2fms",
+                      gst_video_format_to_string (_upload.format),
+                      _upload.width, _upload.height,
+                      (double) _upload.last / GINGA_MSECOND,
+                      (double) (_upload.total / _upload.frames)
+                          / GINGA_MSECOND);
+  return str;
+}
+
+// Draws the current frame; YUV frames are drawn from their plane textures.
+void
+PlayerVideo::redrawTexture ()
+{
+  int nplanes;
+
+  switch (_upload.format)
+    {
+    case GST_VIDEO_FORMAT_I420:
+      nplanes = 3;
+      break;
+    case GST_VIDEO_FORMAT_NV12:
+      nplanes = 2;
+      break;
+    default:
+      Player::redrawTexture ();
+      return;
+    }
+
+  if (_upload.planes[0] == 0)
+    return; // no frame yet
+
+  GL::draw_quad_yuv (Player::_prop.rect.x, Player::_prop.rect.y,
+                     Player::_prop.rect.width, Player::_prop.rect.height,
+                     _upload.planes, nplanes, _upload.bt709,
+                     (GLfloat) (Player::_prop.alpha / 255.));
+}
+
 // Private.
 
 void
@@ -598,6 +962,180 @@ PlayerVideo::getPipelineState ()
   return gst_element_state_get_name (curr);
 }
 
+// Returns the current running time of the pipeline, or GINGA_TIME_NONE if
+// the pipeline has no clock yet.
+Time
+PlayerVideo::getRunningTime ()
+{
+  GstClock *clock;
+  Time now;
+
+  if (_playbin == nullptr)
+    return GINGA_TIME_NONE;
+
+  clock = gst_element_get_clock (_playbin);
+  if (clock == nullptr)
+    return GINGA_TIME_NONE;
+
+  now = gst_clock_get_time (clock) - gst_element_get_base_time (_playbin);
+  gst_object_unref (clock);
+  return now;
+}
+
+// Creates the caps accepted by the video app-sink, with frame size
+// WIDTH x HEIGHT, or any frame size if WIDTH or HEIGHT is 0.  In OpenGL
+// mode, YUV frames are accepted and converted to RGB by the GPU.
+GstCaps *
+PlayerVideo::createCaps (int width, int height)
+{
+  GstCaps *caps;
+
+  if (_opengl)
+    {
+      caps = gst_caps_from_string (PLAYER_VIDEO_GL_CAPS);
+    }
+  else
+    {
+      GstStructure *st = gst_structure_new_empty ("video/x-raw");
+      gst_structure_set (st, "format", G_TYPE_STRING, "BGRA", nullptr);
+      caps = gst_caps_new_full (st, nullptr);
+    }
+  g_assert_nonnull (caps);
+
+  if (width > 0 && height > 0)
+    gst_caps_set_simple (caps, "width", G_TYPE_INT, width, "height",
+                         G_TYPE_INT, height, nullptr);
+  return caps;
+}
+
+// Makes the video scaler output frames at the size of the player rect, so
+// that conversion, copy and upload costs are proportional to the displayed
+// size; the scaler sits before the converter, which keeps the size.
+// Frames are never scaled up; the compositor does that.  The new size is
+// negotiated only when no animation is running; meanwhile, frames keep
+// their current size and are scaled while compositing.  Does nothing
+// unless the scaleVideo option was set when the player was created.
+void
+PlayerVideo::updateScale ()
+{
+  GstPad *pad;
+  GstCaps *caps;
+  GstStructure *st;
+  int width, height;
+  int native_width, native_height;
+
+  if (_video.scale == nullptr || _animator->isRunning ())
+    return;
+
+  pad = gst_element_get_static_pad (_video.scale, "sink");
+  g_assert_nonnull (pad);
+  caps = gst_pad_get_current_caps (pad);
+  gst_object_unref (pad);
+  if (caps == nullptr)
+    return; // not negotiated yet
+
+  st = gst_caps_get_structure (caps, 0);
+  if (unlikely (!gst_structure_get_int (st, "width", &native_width)
+                || !gst_structure_get_int (st, "height", &native_height)))
+    {
+      gst_caps_unref (caps);
+      return;
+    }
+  gst_caps_unref (caps);
+
+  width = MIN (Player::_prop.rect.width, native_width);
+  height = MIN (Player::_prop.rect.height, native_height);
+  if (width <= 0 || height <= 0
+      || (width == native_width && height == native_height))
+    {
+      width = 0;
+      height = 0;
+    }
+
+  if (width == _video.width && height == _video.height)
+    return; // nothing to do
+
+  TRACE ("scaling %s from %dx%d to %dx%d", _id.c_str (), native_width,
+         native_height, width, height);
+  _video.width = width;
+  _video.height = height;
+  caps = this->createCaps (width, height);
+  g_object_set (_video.caps, "caps", caps, nullptr);
+  gst_caps_unref (caps);
+}
+
+// Uploads FRAME to the GPU.  Textures are created on the first frame and
+// whenever the negotiated format or size changes; other frames are
+// uploaded into the existing textures.  YUV frames are uploaded as is, one
+// texture per plane, and converted to RGB when drawn.
+void
+PlayerVideo::uploadFrame (GstVideoFrame *frame)
+{
+  GstVideoFormat format;
+  int width, height;
+  Time t0;
+
+  t0 = (Time) g_get_monotonic_time () * GINGA_USECOND;
+  format = GST_VIDEO_FRAME_FORMAT (frame);
+  width = GST_VIDEO_FRAME_WIDTH (frame);
+  height = GST_VIDEO_FRAME_HEIGHT (frame);
+  if (format != _upload.format || width != _upload.width
+      || height != _upload.height)
+    {
+      this->deleteTextures ();
+      _upload.format = format;
+      _upload.width = width;
+      _upload.height = height;
+      _upload.bt709 = GST_VIDEO_INFO_COLORIMETRY (&frame->info).matrix
+                      == GST_VIDEO_COLOR_MATRIX_BT709;
+    }
+
+  switch (format)
+    {
+    case GST_VIDEO_FORMAT_I420:
+    case GST_VIDEO_FORMAT_NV12:
+      for (guint i = 0; i < GST_VIDEO_FRAME_N_PLANES (frame); i++)
+        {
+          int channels = (format == GST_VIDEO_FORMAT_NV12 && i > 0) ? 2 : 1;
+          GL::upload_plane (
+              &_upload.planes[i], GST_VIDEO_FRAME_COMP_WIDTH (frame, i),
+              GST_VIDEO_FRAME_COMP_HEIGHT (frame, i), channels,
+              GST_VIDEO_FRAME_PLANE_STRIDE (frame, i),
+              (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, i));
+        }
+      break;
+    default:
+      {
+        guint8 *pixels = (guint8 *) GST_VIDEO_FRAME_PLANE_DATA (frame, 0);
+        g_assert (format == GST_VIDEO_FORMAT_BGRA);
+        if (_gltexture == 0)
+          GL::create_texture (&_gltexture, width, height, pixels);
+        else
+          GL::update_subtexture (_gltexture, 0, 0, width, height, pixels);
+        break;
+      }
+    }
+
+  _upload.last = (Time) g_get_monotonic_time () * GINGA_USECOND - t0;
+  _upload.total += _upload.last;
+  _upload.frames++;
+}
+
+// Deletes the textures holding the current frame.
+void
+PlayerVideo::deleteTextures ()
+{
+  if (_gltexture)
+    GL::delete_texture (&_gltexture);
+  _gltexture = 0;
+  for (int i = 0; i < 3; i++)
+    {
+      if (_upload.planes[i])
+        GL::delete_texture (&_upload.planes[i]);
+      _upload.planes[i] = 0;
+    }
+}
+
 // Private: Static (GStreamer callbacks).
 
 gboolean
@@ -676,11 +1214,17 @@ PlayerVideo::cb_Bus (GstBus *bus, GstMessage *msg, PlayerVideo *player)
 }
 
 GstFlowReturn
-PlayerVideo::cb_NewSample (unused (GstAppSink *appsink), gpointer data)
+PlayerVideo::cb_NewSample (GstAppSink *appsink, gpointer data)
 {
   PlayerVideo *player = (PlayerVideo *) data;
+  GstSample *sample;
+
   g_assert_nonnull (player);
-  g_atomic_int_compare_and_exchange (&player->_sample_flag, 0, 1);
+  sample = gst_app_sink_pull_sample (appsink);
+  if (unlikely (sample == nullptr))
+    return GST_FLOW_OK;
+
+  player->_queue.push (sample);
   return GST_FLOW_OK;
 }
 
@@ -695,4 +1239,73 @@ PlayerVideo::cb_EOS (unused (GstElement *playbin), gpointer data)
     player->setEOS (true);
 }
 
+// Installs the decoder probe on the video decoders created by playbin.
+// Playbin creates its decoders inside nested bins, so we also watch the
+// bins added to it.
+void
+PlayerVideo::cb_ElementAdded (unused (GstBin *bin), GstElement *elt,
+                              gpointer data)
+{
+  const gchar *klass;
+  GstPad *pad;
+
+  if (GST_IS_BIN (elt))
+    {
+      g_signal_connect (G_OBJECT (elt), "element-added",
+                        (GCallback) cb_ElementAdded, data);
+      return;
+    }
+
+  klass = gst_element_class_get_metadata (GST_ELEMENT_GET_CLASS (elt),
+                                          GST_ELEMENT_METADATA_KLASS);
+  if (klass == nullptr || strstr (klass, "Decoder") == nullptr
+      || strstr (klass, "Video") == nullptr)
+    return;
+
+  pad = gst_element_get_static_pad (elt, "sink");
+  if (unlikely (pad == nullptr))
+    return;
+  gst_pad_add_probe (pad, GST_PAD_PROBE_TYPE_BUFFER, cb_DecoderProbe, data,
+                     nullptr);
+  gst_object_unref (pad);
+}
+
+// Drops the encoded frames that reach a video decoder while the player is
+// hidden, and the delta frames that follow until the next keyframe.  Each
+// dropped frame is replaced by a gap event so that sinks stay prerolled.
+GstPadProbeReturn
+PlayerVideo::cb_DecoderProbe (GstPad *pad, GstPadProbeInfo *info,
+                              gpointer data)
+{
+  PlayerVideo *player = (PlayerVideo *) data;
+  GstBuffer *buf;
+  GstClockTime ts;
+
+  g_assert_nonnull (player);
+  buf = GST_PAD_PROBE_INFO_BUFFER (info);
+  if (g_atomic_int_get (&player->_decode.hidden))
+    {
+      player->_decode.resync = true;
+    }
+  else if (!player->_decode.resync)
+    {
+      return GST_PAD_PROBE_OK;
+    }
+  else if (!GST_BUFFER_FLAG_IS_SET (buf, GST_BUFFER_FLAG_DELTA_UNIT))
+    {
+      player->_decode.resync = false;
+      return GST_PAD_PROBE_OK;
+    }
+
+  ts = GST_BUFFER_PTS (buf);
+  if (!GST_CLOCK_TIME_IS_VALID (ts))
+    ts = GST_BUFFER_DTS (buf);
+  if (GST_CLOCK_TIME_IS_VALID (ts))
+    gst_pad_send_event (pad,
+                        gst_event_new_gap (ts, GST_BUFFER_DURATION (buf)));
+
+  g_atomic_int_inc (&player->_decode.skipped);
+  return GST_PAD_PROBE_DROP;
+}
+
 GINGA_NAMESPACE_END
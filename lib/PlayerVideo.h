@@ -21,6 +21,52 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 #include "Player.h"
 
 GINGA_NAMESPACE_BEGIN
+
+/// Capacity of the frame queue between the app-sink and the renderer.
+#define PLAYER_VIDEO_QUEUE_SIZE 8
+
+/// Frames presented later than this after their time are counted as late.
+#define PLAYER_VIDEO_LATE_THRESHOLD (20 * GINGA_MSECOND)
+
+/**
+ * @brief Frame-queue counters.
+ */
+typedef struct PlayerVideoQueueStats
+{
+  guint64 presented; ///< Frames popped for presentation.
+  guint dropped;     ///< Frames skipped, or discarded because queue was full.
+  guint64 late;      ///< Frames presented too late.
+  guint64 repeated;  ///< Pops that presented no new frame.
+} PlayerVideoQueueStats;
+
+/**
+ * @brief Queue of decoded video frames.
+ *
+ * Single-producer, single-consumer ring between the app-sink, which pushes
+ * frames from the streaming thread, and the renderer, which pops the frame
+ * that is due at the current running time.
+ */
+class PlayerVideoQueue
+{
+public:
+  PlayerVideoQueue ();
+  ~PlayerVideoQueue ();
+  bool isEmpty ();
+  bool push (GstSample *);
+  GstSample *pop (Time);
+  void flush ();
+  void getStats (PlayerVideoQueueStats *);
+
+private:
+  GstSample *_ring[PLAYER_VIDEO_QUEUE_SIZE]; ///< Queued samples.
+  gint _head;                                ///< Next slot to fill.
+  gint _tail;                                ///< Next slot to present.
+  gint _dropped;                             ///< Frames dropped (atomic).
+  guint64 _presented;                        ///< Frames presented.
+  guint64 _late;                             ///< Frames presented late.
+  guint64 _repeated;                         ///< Pops with no new frame.
+};
+
 class Media;
 class PlayerVideo : public Player
 {
@@ -31,10 +77,17 @@ public:
   void stop () override;
   void pause () override;
   void resume () override;
-  void redraw (cairo_t *) override;
+  string getProperty (const string &) override;
+  bool isOpaque () override;
+  void setHidden (bool) override;
+  void update () override;
+  Time getTimeToNextDeadline () override;
 
 protected:
   bool doSetProperty (Property, const string &, const string &) override;
+  bool isContentDamaged () override;
+  string getDebuggingInfo () override;
+  void redrawTexture () override;
   void seek (gint64);
   void speed (double);
   gint64 getPipelineTime ();
@@ -53,12 +106,38 @@ private:
     GstElement *sink;      // audio sink
   } _audio;
   struct
-  {                   // video pipeline
-    GstElement *bin;  // video bin
-    GstElement *caps; // caps filter
-    GstElement *sink; // app sink
+  {                      // video pipeline
+    GstElement *bin;     // video bin
+    GstElement *scale;   // video scaler
+    GstElement *convert; // video converter (after scaler)
+    GstElement *caps;    // caps filter
+    GstElement *sink;    // app sink
+    int width;           // width requested from scaler (0 = native)
+    int height;          // height requested from scaler (0 = native)
   } _video;
-  int _sample_flag;               // true if new sample is available
+  struct
+  {                       // OpenGL texture upload
+    GstVideoFormat format; // frame format
+    int width;             // frame width
+    int height;            // frame height
+    guint planes[3];       // plane textures (YUV formats only)
+    bool bt709;            // whether YUV frames use BT.709 colors
+    Time last;             // time spent uploading last frame
+    Time total;            // time spent uploading all frames
+    guint64 frames;        // number of frames uploaded
+  } _upload;
+  PlayerVideoQueue _queue; // frame queue
+  struct
+  {             // last frame presented
+    int width;  // frame width
+    int height; // frame height
+  } _frames;
+  struct
+  {               // video decoding
+    gint hidden;  // whether player is hidden (accessed atomically)
+    bool resync;  // whether to wait for a keyframe (streaming thread)
+    gint skipped; // encoded frames not decoded (accessed atomically)
+  } _decode;
   GstAppSinkCallbacks _callbacks; // video app-sink callback data
   struct
   {
@@ -83,11 +162,19 @@ private:
   void doStackedActions ();
   bool getFreeze ();
   string getPipelineState ();
+  Time getRunningTime ();
+  GstCaps *createCaps (int, int);
+  void updateScale ();
+  void uploadFrame (GstVideoFrame *);
+  void deleteTextures ();
 
   // GStreamer callbacks.
   static gboolean cb_Bus (GstBus *, GstMessage *, PlayerVideo *);
   static GstFlowReturn cb_NewSample (GstAppSink *, gpointer);
   static void cb_EOS (GstElement *, gpointer);
+  static void cb_ElementAdded (GstBin *, GstElement *, gpointer);
+  static GstPadProbeReturn cb_DecoderProbe (GstPad *, GstPadProbeInfo *,
+                                            gpointer);
 };
 
 GINGA_NAMESPACE_END
@@ -27,6 +27,7 @@ Predicate::Predicate (Predicate::Type type)
   _atom.test = Predicate::EQ;
   _atom.left = "";
   _atom.right = "";
+  _compiled = false;
 }
 
 Predicate::~Predicate ()
@@ -138,6 +139,7 @@ Predicate::setTest (const string &left, Predicate::Test test,
   _atom.test = test;
   _atom.left = left;
   _atom.right = right;
+  this->resetProgram ();
 }
 
 void
@@ -173,6 +175,7 @@ Predicate::addChild (Predicate *child)
     }
   child->initParent (this);
   _children.push_back (child);
+  this->resetProgram ();
 }
 
 void
@@ -189,4 +192,42 @@ Predicate::getParent ()
   return _parent;
 }
 
+/**
+ * @brief Gets the compiled form of predicate.
+ * @return The compiled program, or null if predicate is not compiled.
+ */
+const vector<Predicate::Instr> *
+Predicate::getProgram ()
+{
+  return (_compiled) ? &_program : nullptr;
+}
+
+/**
+ * @brief Sets the compiled form of predicate.
+ *
+ * The program is produced by Document::compilePredicate() and is valid
+ * until the predicate or one of its children changes.
+ *
+ * @param program The compiled program.
+ */
+void
+Predicate::setProgram (const vector<Predicate::Instr> &program)
+{
+  _program = program;
+  _compiled = true;
+}
+
+/**
+ * @brief Discards the compiled form of predicate and of its ancestors.
+ */
+void
+Predicate::resetProgram ()
+{
+  for (Predicate *pred = this; pred != nullptr; pred = pred->_parent)
+    {
+      pred->_program.clear ();
+      pred->_compiled = false;
+    }
+}
+
 GINGA_NAMESPACE_END
@@ -22,6 +22,8 @@ along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
 
 GINGA_NAMESPACE_BEGIN
 
+class Object;
+
 class Predicate
 {
 public:
@@ -45,6 +47,36 @@ public:
     GE      // >=
   };
 
+  /// Operand of compiled atomic test.
+  struct Operand
+  {
+    string text;              ///< Literal text or unresolved reference.
+    Object *object = nullptr; ///< Referenced object, or null.
+    string name;              ///< Name of referenced property.
+    bool ref = false;         ///< Whether text is an unresolved reference.
+    bool numeric = false;     ///< Whether literal text is a number.
+    double number = 0;        ///< Literal text as number.
+  };
+
+  /// Instruction of compiled predicate.
+  struct Instr
+  {
+    enum Opcode
+    {
+      CONST = 0,     // acc = value
+      TEST,          // acc = left test right
+      NOT,           // acc = !acc
+      JUMP_IF_FALSE, // if (!acc) goto target
+      JUMP_IF_TRUE,  // if (acc) goto target
+    };
+    Opcode opcode = CONST;                ///< Opcode.
+    bool value = false;                   ///< Constant value.
+    Predicate::Test test = Predicate::EQ; ///< Test.
+    Operand left;                         ///< Left operand of test.
+    Operand right;                        ///< Right operand of test.
+    size_t target = 0;                    ///< Jump target.
+  };
+
   explicit Predicate (Predicate::Type);
   ~Predicate ();
   Predicate::Type getType ();
@@ -63,6 +95,11 @@ public:
   Predicate *getParent ();
   void initParent (Predicate *);
 
+  // Compiled form.
+  const vector<Predicate::Instr> *getProgram ();
+  void setProgram (const vector<Predicate::Instr> &);
+  void resetProgram ();
+
 private:
   Predicate::Type _type;
   struct
@@ -73,6 +110,8 @@ private:
   } _atom;
   list<Predicate *> _children;
   Predicate *_parent;
+  vector<Predicate::Instr> _program; ///< Compiled form.
+  bool _compiled;                    ///< Whether compiled form is valid.
 };
 
 GINGA_NAMESPACE_END
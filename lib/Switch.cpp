@@ -27,6 +27,8 @@ GINGA_NAMESPACE_BEGIN
 Switch::Switch (const string &id) : Composition (id)
 {
   _selected = nullptr;
+  _watching = false;
+  _cacheable = false;
 }
 
 Switch::~Switch ()
@@ -94,46 +96,30 @@ Switch::beforeTransition (Event *evt, Event::Transition transition)
       switch (transition)
         {
         case Event::START:
-          g_assert_null (_selected);
-          for (auto item : _rules)
-            {
-              Object *obj;
-              Predicate *pred;
-              Event *selected_evt;
-
-              obj = item.first;
-              g_assert_nonnull (obj);
-              pred = item.second;
-              g_assert_nonnull (pred);
-
-              // Check if the (possible) selected object is in the
-              // switchPort's
-              // list of possible events.
-              selected_evt = nullptr;
-              for (Event *e : switchPort_evts)
-                {
-                  if (obj == e->getObject ())
-                    selected_evt = e;
-                }
-              if (selected_evt == nullptr)
-                continue;
-
-              if (_doc->evalPredicate (pred))
-                {
-                  g_assert_nonnull (selected_evt);
-                  // Found one valid predicate.
-                  if (selected_evt->transition (transition))
-                    {
-                      _selected = obj;
-                      return true;
-                    } // Found one valid predicate, but its transition
-                      // doesn't work.
-                  else
-                    return false;
-                }
-            }
-          // Not found valid predicate, then transition failed.
-          return false;
+          {
+            Object *obj;
+            Event *selected_evt;
+
+            g_assert_null (_selected);
+            obj = this->evalRules (evt, switchPort_evts);
+            if (obj == nullptr)
+              return false; // no valid predicate, transition failed
+
+            selected_evt = nullptr;
+            for (Event *e : switchPort_evts)
+              {
+                if (obj == e->getObject ())
+                  selected_evt = e;
+              }
+            g_assert_nonnull (selected_evt);
+
+            // Found one valid predicate, but its transition may not work.
+            if (!selected_evt->transition (transition))
+              return false;
+
+            _selected = obj;
+            return true;
+          }
           break;
 
         case Event::PAUSE:
@@ -211,6 +197,12 @@ Switch::afterTransition (Event *evt, Event::Transition transition)
   return true;
 }
 
+void
+Switch::propertyChanged (unused (Object *obj), unused (const string &name))
+{
+  _selection.clear ();
+}
+
 // Public.
 
 const list<pair<Object *, Predicate *> > *
@@ -225,6 +217,8 @@ Switch::addRule (Object *obj, Predicate *pred)
   g_assert_nonnull (obj);
   g_assert_nonnull (pred);
   _rules.push_back (std::make_pair (obj, pred));
+  _selection.clear ();
+  _watching = false;
 }
 
 const map<string, list<Event *> > *
@@ -244,4 +238,113 @@ Switch::addSwitchPort (const string &id, const list<Event *> &evts)
   _switchPorts[id] = evts;
 }
 
+// Private.
+
+/**
+ * @brief Selects the object of the first rule that holds.
+ *
+ * Only rules whose object has an event in \p evts are considered.  The
+ * result is cached per \p evt and reused until one of the properties
+ * referenced by the rules changes.
+ *
+ * @param evt The switch event being started.
+ * @param evts The events that can be selected.
+ * @return The selected object, or null if no rule holds.
+ */
+Object *
+Switch::evalRules (Event *evt, const set<Event *> &evts)
+{
+  Object *result;
+
+  if (!_watching)
+    this->watchRules ();
+
+  if (_cacheable)
+    {
+      auto it = _selection.find (evt);
+      if (it != _selection.end ())
+        return it->second;
+    }
+
+  result = nullptr;
+  for (auto item : _rules)
+    {
+      Object *obj;
+      Predicate *pred;
+      bool found;
+
+      obj = item.first;
+      g_assert_nonnull (obj);
+      pred = item.second;
+      g_assert_nonnull (pred);
+
+      // Check if the (possible) selected object is in the list of
+      // possible events.
+      found = false;
+      for (Event *e : evts)
+        {
+          if (obj == e->getObject ())
+            {
+              found = true;
+              break;
+            }
+        }
+      if (!found)
+        continue;
+
+      if (_doc->evalPredicate (pred))
+        {
+          result = obj;
+          break;
+        }
+    }
+
+  if (_cacheable)
+    _selection[evt] = result;
+
+  return result;
+}
+
+/**
+ * @brief Watches the properties referenced by rules.
+ *
+ * Compiles the rule predicates and adds the switch as watcher of every
+ * property they reference, so that propertyChanged() can drop the cached
+ * selection.  If some reference cannot be resolved to an object, the
+ * selection is never cached.  Rules are not expected to change once the
+ * switch has started, except by addRule().
+ */
+void
+Switch::watchRules ()
+{
+  _cacheable = true;
+  for (auto item : _rules)
+    {
+      Predicate *pred;
+      const vector<Predicate::Instr> *prog;
+
+      pred = item.second;
+      g_assert_nonnull (pred);
+      _doc->compilePredicate (pred);
+      prog = pred->getProgram ();
+      g_assert_nonnull (prog);
+
+      for (auto &instr : *prog)
+        {
+          if (instr.opcode != Predicate::Instr::TEST)
+            continue;
+          const Predicate::Operand *ops[] = { &instr.left, &instr.right };
+          for (auto op : ops)
+            {
+              if (op->object != nullptr)
+                op->object->addPropertyWatcher (op->name, this);
+              else if (op->ref)
+                _cacheable = false;
+            }
+        }
+    }
+  _selection.clear ();
+  _watching = true;
+}
+
 GINGA_NAMESPACE_END
@@ -34,6 +34,7 @@ public:
   string toString () override;
   bool beforeTransition (Event *, Event::Transition) override;
   bool afterTransition (Event *, Event::Transition) override;
+  void propertyChanged (Object *, const string &) override;
 
   // Switch:
   const list<pair<Object *, Predicate *> > *getRules ();
@@ -45,6 +46,12 @@ private:
   map<string, list<Event *> > _switchPorts; ///< List of switchPorts.
   list<pair<Object *, Predicate *> > _rules;
   Object *_selected;
+  map<Event *, Object *> _selection; ///< Cached selection per event.
+  bool _watching;  ///< Whether rule dependencies are being watched.
+  bool _cacheable; ///< Whether selection can be cached.
+
+  Object *evalRules (Event *, const set<Event *> &);
+  void watchRules ();
 };
 
 GINGA_NAMESPACE_END
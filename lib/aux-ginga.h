@@ -56,6 +56,7 @@ GINGA_END_DECLS
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 using namespace std;
 
@@ -41,17 +41,44 @@ auto vertexSource = R"glsl(
 static auto fragmentSource = R"glsl(
   #version 330 core
   uniform int use_tex;
-  uniform sampler2D tex;
+  uniform int yuv;          // 0: RGBA, 1: I420 (3 planes), 2: NV12 (2 planes)
+  uniform int bt709;        // whether YUV uses BT.709 instead of BT.601
+  uniform sampler2D tex;    // RGBA texture or Y plane
+  uniform sampler2D tex_u;  // U plane (I420) or UV plane (NV12)
+  uniform sampler2D tex_v;  // V plane (I420)
 
   in vec4 f_color;
   in vec2 f_texcoord;
 
   out vec4 outColor;
 
+  vec4
+  yuv_to_rgba (float y, float u, float v)
+  {
+    y = 1.164 * (y - 0.0625);
+    u -= 0.5;
+    v -= 0.5;
+    if (bt709 != 0)
+      return vec4 (y + 1.793 * v, y - 0.213 * u - 0.533 * v,
+                   y + 2.112 * u, 1.0);
+    return vec4 (y + 1.596 * v, y - 0.392 * u - 0.813 * v,
+                 y + 2.017 * u, 1.0);
+  }
+
   void
   main ()
   {
-    vec4 t0 = texture2D (tex, f_texcoord);
+    vec4 t0;
+    if (yuv == 1)
+      t0 = yuv_to_rgba (texture2D (tex, f_texcoord).r,
+                        texture2D (tex_u, f_texcoord).r,
+                        texture2D (tex_v, f_texcoord).r);
+    else if (yuv == 2)
+      t0 = yuv_to_rgba (texture2D (tex, f_texcoord).r,
+                        texture2D (tex_u, f_texcoord).r,
+                        texture2D (tex_u, f_texcoord).g);
+    else
+      t0 = texture2D (tex, f_texcoord);
     outColor = use_tex * t0 * f_color + (1.0 - use_tex) * f_color;
   })glsl";
 
@@ -353,22 +380,11 @@ GL::update_subtexture (GLuint gltex, int xoffset, int yoffset, int width,
 #endif
 }
 
-/**
- * @brief GL::draw_quad Draws a textured rectangle
- */
-void
-GL::draw_quad (int x, int y, int w, int h, GLuint gltex, GLfloat alpha)
+#if defined WITH_OPENGL && WITH_OPENGL
+// Draws a rectangle textured with the textures currently bound.
+static void
+draw_textured_quad (int x, int y, int w, int h, GLfloat alpha)
 {
-#if !(defined WITH_OPENGL && WITH_OPENGL)
-  ignore_unused (x, y, w, h, gltex, alpha);
-  ERROR_NOT_IMPLEMENTED ("not compiled with OpenGL support");
-#else
-  g_assert (gltex > 0);
-  glActiveTexture (GL_TEXTURE0);
-  glBindTexture (GL_TEXTURE_2D, gltex);
-
-  CHECK_GL_ERROR ();
-
   GLint loc = glGetUniformLocation (gles2ctx.shaderProgram, "use_tex");
   glUniform1i (loc, 1);
 
@@ -428,6 +444,97 @@ GL::draw_quad (int x, int y, int w, int h, GLuint gltex, GLfloat alpha)
 
   // glDrawArrays (GL_TRIANGLES, 0, 3);
   glDrawElements (GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+}
+#endif
+
+/**
+ * @brief GL::upload_plane Uploads one plane of a video frame into a
+ *  single- or two-channel texture, creating the texture if *gltex is 0.
+ *  Stride is the length in bytes of each row of data.  OpenGL ES 2 cannot
+ *  skip row padding, so there padded rows are first copied into a tight
+ *  buffer.
+ */
+void
+GL::upload_plane (GLuint *gltex, int width, int height, int channels,
+                  int stride, unsigned char *data)
+{
+#if !(defined WITH_OPENGL && WITH_OPENGL)
+  ignore_unused (gltex, width, height, channels, stride, data);
+  ERROR_NOT_IMPLEMENTED ("not compiled with OpenGL support");
+#else
+  GLenum format;
+#if WITH_OPENGLES2
+  unsigned char *packed = nullptr;
+#endif
+
+  g_assert (channels == 1 || channels == 2);
+#if WITH_OPENGLES2
+  g_assert (channels == 1);
+  format = GL_LUMINANCE;
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+  if (stride != width)
+    {
+      g_assert (stride > width);
+      packed = (unsigned char *) g_malloc ((gsize) width * (gsize) height);
+      for (int y = 0; y < height; y++)
+        memcpy (packed + (gsize) y * (gsize) width,
+                data + (gsize) y * (gsize) stride, (gsize) width);
+      data = packed;
+    }
+#else
+  format = (channels == 1) ? GL_RED : GL_RG;
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 1);
+  glPixelStorei (GL_UNPACK_ROW_LENGTH, stride / channels);
+#endif
+
+  if (*gltex == 0)
+    {
+      glActiveTexture (GL_TEXTURE0);
+      glGenTextures (1, gltex);
+      glBindTexture (GL_TEXTURE_2D, *gltex);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+      glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+      glTexImage2D (GL_TEXTURE_2D, 0, (GLint) format, width, height, 0,
+                    format, GL_UNSIGNED_BYTE, data);
+    }
+  else
+    {
+      glBindTexture (GL_TEXTURE_2D, *gltex);
+      glTexSubImage2D (GL_TEXTURE_2D, 0, 0, 0, width, height, format,
+                       GL_UNSIGNED_BYTE, data);
+    }
+  glBindTexture (GL_TEXTURE_2D, 0);
+
+#if WITH_OPENGLES2
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+  g_free (packed);
+#else
+  glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
+  glPixelStorei (GL_UNPACK_ALIGNMENT, 4);
+#endif
+  CHECK_GL_ERROR ();
+#endif
+}
+
+/**
+ * @brief GL::draw_quad Draws a textured rectangle
+ */
+void
+GL::draw_quad (int x, int y, int w, int h, GLuint gltex, GLfloat alpha)
+{
+#if !(defined WITH_OPENGL && WITH_OPENGL)
+  ignore_unused (x, y, w, h, gltex, alpha);
+  ERROR_NOT_IMPLEMENTED ("not compiled with OpenGL support");
+#else
+  g_assert (gltex > 0);
+  glActiveTexture (GL_TEXTURE0);
+  glBindTexture (GL_TEXTURE_2D, gltex);
+
+  CHECK_GL_ERROR ();
+
+  draw_textured_quad (x, y, w, h, alpha);
 
   glBindTexture (GL_TEXTURE_2D, 0);
 
@@ -485,3 +592,50 @@ GL::draw_quad (int x, int y, int w, int h, GLfloat r, GLfloat g, GLfloat b,
   CHECK_GL_ERROR ();
 #endif
 }
+
+/**
+ * @brief GL::draw_quad_yuv Draws a rectangle textured with a YUV video
+ *  frame, converting it to RGB in the fragment shader.  The frame is
+ *  either I420 (3 planes: Y, U and V) or NV12 (2 planes: Y and UV).
+ */
+void
+GL::draw_quad_yuv (int x, int y, int w, int h, const GLuint *planes,
+                   int nplanes, bool bt709, GLfloat alpha)
+{
+#if !(defined WITH_OPENGL && WITH_OPENGL)
+  ignore_unused (x, y, w, h, planes, nplanes, bt709, alpha);
+  ERROR_NOT_IMPLEMENTED ("not compiled with OpenGL support");
+#else
+  static const char *samplers[] = { "tex", "tex_u", "tex_v" };
+  GLint loc;
+
+  g_assert (nplanes == 2 || nplanes == 3);
+  for (int i = 0; i < nplanes; i++)
+    {
+      g_assert (planes[i] > 0);
+      glActiveTexture ((GLenum) (GL_TEXTURE0 + i));
+      glBindTexture (GL_TEXTURE_2D, planes[i]);
+      loc = glGetUniformLocation (gles2ctx.shaderProgram, samplers[i]);
+      glUniform1i (loc, i);
+    }
+
+  loc = glGetUniformLocation (gles2ctx.shaderProgram, "yuv");
+  glUniform1i (loc, (nplanes == 3) ? 1 : 2);
+  loc = glGetUniformLocation (gles2ctx.shaderProgram, "bt709");
+  glUniform1i (loc, bt709 ? 1 : 0);
+
+  CHECK_GL_ERROR ();
+
+  draw_textured_quad (x, y, w, h, alpha);
+
+  loc = glGetUniformLocation (gles2ctx.shaderProgram, "yuv");
+  glUniform1i (loc, 0);
+  for (int i = nplanes - 1; i >= 0; i--)
+    {
+      glActiveTexture ((GLenum) (GL_TEXTURE0 + i));
+      glBindTexture (GL_TEXTURE_2D, 0);
+    }
+
+  CHECK_GL_ERROR ();
+#endif
+}
@@ -63,10 +63,13 @@ public:
   static void update_texture (GLuint, int, int, unsigned char *);
   static void update_subtexture (GLuint, int, int, int, int,
                                  unsigned char *);
+  static void upload_plane (GLuint *, int, int, int, int, unsigned char *);
 
   static void draw_quad (int, int, int, int, GLuint, GLfloat a = 1.0f);
   static void draw_quad (int, int, int, int, GLfloat, GLfloat, GLfloat,
                          GLfloat);
+  static void draw_quad_yuv (int, int, int, int, const GLuint *, int, bool,
+                             GLfloat a = 1.0f);
 };
 
 #endif // AUX_GINGA_H
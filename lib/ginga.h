@@ -61,6 +61,38 @@ struct GingaOptions
 
   /// @brief Background color.
   std::string background;
+
+  /// @brief Memory budget of the decoded-image cache (in kilobytes).
+  /// @remark The cache is shared by all Ginga objects in the process.
+  int imageCacheSize;
+
+  /// @brief Whether to decode images in the calling thread.
+  /// @remark By default, images are decoded by worker threads and drawn
+  /// when ready; blocking makes presentation deterministic (e.g., for
+  /// tests).
+  bool syncImageDecode;
+
+  /// @brief Whether to parse NCL documents in streaming mode.
+  /// @remark In streaming mode, documents are read by a LibXML text
+  /// reader and processed as they are read, instead of being loaded into
+  /// a complete DOM tree first.
+  bool streamingParse;
+
+  /// @brief Whether to parse NCL documents in a background thread.
+  /// @remark In background mode, Ginga::start returns immediately and the
+  /// host keeps ticking and drawing (the background) while the document is
+  /// parsed; the document is started by the first tick after it is ready.
+  /// The document is attached as a whole, so this does not make the first
+  /// frame arrive sooner than a synchronous parse would.
+  bool backgroundParse;
+
+  /// @brief Whether to scale video frames down to the size of their
+  /// players before they reach Ginga.
+  /// @remark Scaling in the decoding pipeline makes conversion, copy and
+  /// upload costs proportional to the displayed size, at the price of a
+  /// caps renegotiation whenever a player is resized.  Only players
+  /// created after the option is set are affected.
+  bool scaleVideo;
 };
 
 /**
@@ -72,6 +104,12 @@ typedef enum
  GINGA_STATE_STOPPED,           ///< Ginga is stopped.
 } GingaState;
 
+/**
+ * @brief Function called to wake up a host that sleeps between ticks.
+ * @param data User data given to Ginga::setWakeupCallback().
+ */
+typedef void (*GingaWakeupFunc) (void *data);
+
 /**
  * @brief Ginga handle.
  *
@@ -89,9 +127,11 @@ public:
 
   virtual void resize (int width, int height) = 0;
   virtual void redraw (cairo_t *cr) = 0;
+  virtual bool getDamage (cairo_region_t *region) = 0;
 
   virtual bool sendKey (const std::string &key, bool press) = 0;
   virtual bool sendTick (uint64_t total, uint64_t diff, uint64_t frame) = 0;
+  virtual bool getNextDeadline (uint64_t *delay, bool *redraw) = 0;
 
   virtual const GingaOptions *getOptions () = 0;
   virtual bool getOptionBool (const std::string &name) = 0;
@@ -103,6 +143,9 @@ public:
                                 std::string value) = 0;
 
   static Ginga *create (const GingaOptions *opts);
+  static void setWakeupCallback (GingaWakeupFunc func, void *data);
+  static bool precompile (const std::string &path,
+                          const GingaOptions *opts, std::string *errmsg);
   static std::string version ();
 };
 
@@ -138,6 +138,17 @@ static G_GNUC_PRINTF (2, 3) void _error (gboolean try_help,
     g_fprintf (stderr, "Try '%s --help' for more information.\n", me);
 }
 
+// Called by Ginga from a background thread; wakes up the main loop.
+static void
+ginga_wakeup (unused (void *data))
+{
+  SDL_Event event;
+
+  SDL_zero (event);
+  event.type = SDL_USEREVENT;
+  SDL_PushEvent (&event);
+}
+
 static void
 sendTickEvent ()
 {
@@ -238,9 +249,15 @@ main (int argc, char **argv)
   opts.experimental = opt_experimental;
   opts.opengl = true;
   opts.background = string (opt_background);
+  opts.imageCacheSize = 32768;
+  opts.syncImageDecode = false;
+  opts.streamingParse = false;
+  opts.backgroundParse = false;
+  opts.scaleVideo = false;
   opts.opengl = true;
   GINGA = Ginga::create (&opts);
   g_assert_nonnull (GINGA);
+  Ginga::setWakeupCallback (ginga_wakeup, nullptr);
 
   string errmsg;
   if (!GINGA->start (string (saved_argv[1]), &errmsg))
@@ -256,6 +273,10 @@ main (int argc, char **argv)
   bool quit = false;
   while (!quit)
     {
+      uint64_t delay;
+      bool redraw;
+      bool exposed = false;
+
       while (SDL_PollEvent (&event) != 0)
         {
           // User requests quit
@@ -270,6 +291,9 @@ main (int argc, char **argv)
                 case SDL_WINDOWEVENT_RESIZED:
                   GINGA->resize (event.window.data1, event.window.data2);
                   break;
+                case SDL_WINDOWEVENT_EXPOSED:
+                  exposed = true;
+                  break;
                 default:
                   break;
                 }
@@ -277,10 +301,23 @@ main (int argc, char **argv)
         }
 
       sendTickEvent ();
-      GINGA->redraw (nullptr);
+      if (!GINGA->getNextDeadline (&delay, &redraw))
+        delay = (uint64_t) -1;
+
+      if (redraw || exposed)
+        {
+          GINGA->redraw (nullptr);
+          SDL_GL_SwapWindow (window);
+        }
 
-      SDL_GL_SwapWindow (window);
-      SDL_Delay (11);
+      // Sleep until the next deadline or the next window event.
+      if (delay == (uint64_t) -1)
+        SDL_WaitEvent (nullptr);
+      else if (delay > 11 * (uint64_t) 1000000)
+        SDL_WaitEventTimeout (nullptr,
+                              (int) MIN (delay / 1000000, G_MAXINT));
+      else
+        SDL_Delay (11);
     }
 
   GINGA->stop ();
@@ -1,4 +1,5 @@
 #include <glib.h>
+#include <math.h>
 
 #include <QApplication>
 #include <QElapsedTimer>
@@ -29,10 +30,16 @@ public:
     _ginga_opts.experimental = FALSE;
     _ginga_opts.background = "black";
     _ginga_opts.opengl = false;
+    _ginga_opts.imageCacheSize = 32768;
+    _ginga_opts.syncImageDecode = false;
+    _ginga_opts.streamingParse = false;
+    _ginga_opts.backgroundParse = false;
+    _ginga_opts.scaleVideo = false;
 
     _ginga = Ginga::create (&_ginga_opts);
 
     g_assert_nonnull (_ginga);
+    Ginga::setWakeupCallback (wakeup, this);
 
     connect (&_timer, SIGNAL (timeout ()), this, SLOT (redrawGinga ()));
   }
@@ -40,6 +47,7 @@ public:
   //! Destructor.
   virtual ~GingaQt ()
   {
+    Ginga::setWakeupCallback (nullptr, nullptr);
     delete _ginga;
     cairo_destroy (_cr);
     cairo_surface_destroy (_ginga_surface);
@@ -107,7 +115,41 @@ protected Q_SLOTS:
     _ginga->sendTick (time - first, time - last, frame);
     last = time;
 
+    // Sleep until the presentation needs the next tick.
+    uint64_t delay;
+    if (_ginga->getNextDeadline (&delay, nullptr))
+      _timer.start ((int) MAX (33, MIN (delay / 1000000, G_MAXINT)));
+    else
+      _timer.stop ();
+
+    // Repaint only the part of the frame that changed.
+    cairo_region_t *damage = cairo_region_create ();
+    if (!_ginga->getDamage (damage))
+      {
+        cairo_region_destroy (damage);
+        return; // nothing to do
+      }
+
+    QRegion region;
+    double sx = (double) width ()
+                / cairo_image_surface_get_width (_ginga_surface);
+    double sy = (double) height ()
+                / cairo_image_surface_get_height (_ginga_surface);
+
+    cairo_save (_cr);
+    for (int i = 0; i < cairo_region_num_rectangles (damage); i++)
+      {
+        cairo_rectangle_int_t r;
+        cairo_region_get_rectangle (damage, i, &r);
+        cairo_rectangle (_cr, r.x, r.y, r.width, r.height);
+        region += QRect ((int) floor (r.x * sx), (int) floor (r.y * sy),
+                         (int) ceil (r.width * sx) + 1,
+                         (int) ceil (r.height * sy) + 1);
+      }
+    cairo_clip (_cr);
     _ginga->redraw (_cr);
+    cairo_restore (_cr);
+    cairo_region_destroy (damage);
 
     _img = QImage (cairo_image_surface_get_data (_ginga_surface),
                    cairo_image_surface_get_width (_ginga_surface),
@@ -118,10 +160,18 @@ protected Q_SLOTS:
                       cairo_image_surface_get_stride (_ginga_surface));
 
     _img = _img.scaled (width (), height ());
-    update ();
+    update (region);
   }
 
 private:
+  //! Called by Ginga from a background thread; ticks it in the main loop.
+  static void
+  wakeup (void *data)
+  {
+    QMetaObject::invokeMethod ((GingaQt *) data, "redrawGinga",
+                              Qt::QueuedConnection);
+  }
+
   Ginga *_ginga;
   GingaOptions _ginga_opts;
 
@@ -39,10 +39,15 @@ static Ginga *GINGA = nullptr;
   "Report bugs to: " PACKAGE_BUGREPORT "\n"                                \
   "Ginga home page: " PACKAGE_URL
 
+static gboolean opt_bg_parse = FALSE;     // parse in background thread
 static gboolean opt_debug = FALSE;        // toggle debug
 static gboolean opt_experimental = FALSE; // toggle experimental stuff
 static gboolean opt_fullscreen = FALSE;   // toggle fullscreen-mode
+static gint opt_image_cache = 32768;      // image cache size (in KB)
 static gboolean opt_opengl = FALSE;       // toggle OpenGL backend
+static gboolean opt_precompile = FALSE;   // precompile files and exit
+static gboolean opt_scale_video = FALSE;  // scale video in pipeline
+static gboolean opt_streaming = FALSE;    // parse in streaming mode
 static string opt_background = "";        // background color
 static gint opt_width = 800;              // initial window width
 static gint opt_height = 600;             // initial window height
@@ -95,14 +100,24 @@ opt_version_cb (void)
 static GOptionEntry options[]
     = { { "background", 'b', 0, G_OPTION_ARG_CALLBACK,
           pointerof (opt_background_cb), "Set background color", "COLOR" },
+        { "background-parse", 0, 0, G_OPTION_ARG_NONE, &opt_bg_parse,
+          "Parse documents in a background thread", NULL },
         { "debug", 'd', 0, G_OPTION_ARG_NONE, &opt_debug,
           "Enable debugging", NULL },
         { "fullscreen", 'f', 0, G_OPTION_ARG_NONE, &opt_fullscreen,
           "Enable full-screen mode", NULL },
+        { "image-cache", 'i', 0, G_OPTION_ARG_INT, &opt_image_cache,
+          "Set decoded-image cache size", "KB" },
         { "opengl", 'g', 0, G_OPTION_ARG_NONE, &opt_opengl,
           "Use OpenGL backend", NULL },
+        { "precompile", 'p', 0, G_OPTION_ARG_NONE, &opt_precompile,
+          "Precompile files for faster startup and exit", NULL },
+        { "scale-video", 0, 0, G_OPTION_ARG_NONE, &opt_scale_video,
+          "Scale video frames to player size while decoding", NULL },
         { "size", 's', 0, G_OPTION_ARG_CALLBACK, pointerof (opt_size_cb),
           "Set initial window size", "WIDTHxHEIGHT" },
+        { "streaming-parse", 0, 0, G_OPTION_ARG_NONE, &opt_streaming,
+          "Parse documents in streaming mode", NULL },
         { "experimental", 'x', 0, G_OPTION_ARG_NONE, &opt_experimental,
           "Enable experimental stuff", NULL },
         { "version", 0, G_OPTION_FLAG_NO_ARG, G_OPTION_ARG_CALLBACK,
@@ -138,6 +153,24 @@ static G_GNUC_PRINTF (3, 4) void _error (gboolean try_help, int die,
     _exit (die);
 }
 
+// Tick scheduling.
+//
+// The presentation is ticked on every frame only while it needs so, as
+// reported by Ginga::getNextDeadline().  Otherwise, the tick callback is
+// removed and a timeout installs it back when the next deadline is due.
+// If nothing is scheduled, the tick callback is installed back only when
+// the next key is sent, or when Ginga wakes us up after finishing some
+// background work.
+
+#define TICK_PERIOD ((uint64_t) 1000000000 / 60) // frame period (in ns)
+
+static guint tick_id = 0;   // tick callback id (0 if not ticking)
+static guint wakeup_id = 0; // wake-up timeout id (0 if not sleeping)
+
+static gboolean wakeup_callback (GtkWidget *);
+static gboolean resume_callback (GtkWidget *);
+static void start_ticking (GtkWidget *);
+
 // Callbacks.
 
 #if GTK_CHECK_VERSION(3, 16, 0)
@@ -194,6 +227,7 @@ keyboard_callback (GtkWidget *widget, GdkEventKey *e, gpointer type)
         return TRUE;
       opt_debug = !opt_debug;
       GINGA->setOptionBool ("debug", opt_debug);
+      start_ticking (widget);
       return TRUE;
     case GDK_KEY_F11: // toggle full-screen
       if (g_str_equal ((const char *) type, "release"))
@@ -252,6 +286,7 @@ keyboard_callback (GtkWidget *widget, GdkEventKey *e, gpointer type)
 
   bool status = GINGA->sendKey (
       string (key), g_str_equal ((const char *) type, "press") == 0);
+  start_ticking (widget);
 
   if (free_key)
     g_free (deconst (char *, key));
@@ -275,6 +310,8 @@ tick_callback (GtkWidget *widget)
 #endif
 {
   guint64 time;
+  uint64_t delay;
+  bool redraw;
   static guint64 frame = (guint64) -1;
   static guint64 last;
   static guint64 first;
@@ -297,12 +334,80 @@ tick_callback (GtkWidget *widget)
     {
       g_assert (GINGA->getState () == GINGA_STATE_STOPPED);
       gtk_main_quit (); // all done
+      tick_id = 0;
       return G_SOURCE_REMOVE;
     }
 
   last = time;
-  gtk_widget_queue_draw (widget);
-  return G_SOURCE_CONTINUE;
+
+  if (!GINGA->getNextDeadline (&delay, &redraw))
+    delay = (uint64_t) -1;
+
+  // In cairo mode, invalidate only the part of the window that changed.
+  if (opt_opengl)
+    {
+      if (redraw)
+        gtk_widget_queue_draw (widget);
+    }
+  else if (redraw)
+    {
+      cairo_region_t *damage = cairo_region_create ();
+      if (GINGA->getDamage (damage))
+        gtk_widget_queue_draw_region (widget, damage);
+      cairo_region_destroy (damage);
+    }
+
+  // Keep ticking while the presentation needs a tick on every frame;
+  // otherwise, sleep until the next deadline (or the next key).
+  if (delay < TICK_PERIOD)
+    return G_SOURCE_CONTINUE;
+
+  tick_id = 0;
+  if (delay != (uint64_t) -1)
+    wakeup_id = g_timeout_add ((guint) MIN (delay / 1000000, G_MAXUINT),
+                               (GSourceFunc) wakeup_callback, widget);
+  return G_SOURCE_REMOVE;
+}
+
+static gboolean
+wakeup_callback (GtkWidget *widget)
+{
+  wakeup_id = 0;
+  start_ticking (widget);
+  return G_SOURCE_REMOVE;
+}
+
+// Called by Ginga from a background thread; resumes ticking in the main
+// loop.
+static void
+ginga_wakeup (void *widget)
+{
+  g_idle_add ((GSourceFunc) resume_callback, widget);
+}
+
+static gboolean
+resume_callback (GtkWidget *widget)
+{
+  start_ticking (widget);
+  return G_SOURCE_REMOVE;
+}
+
+static void
+start_ticking (GtkWidget *widget)
+{
+  if (wakeup_id != 0)
+    {
+      g_source_remove (wakeup_id);
+      wakeup_id = 0;
+    }
+  if (tick_id != 0)
+    return; // already ticking
+#if GTK_CHECK_VERSION(3, 8, 0)
+  tick_id = gtk_widget_add_tick_callback (
+      widget, (GtkTickCallback) tick_callback, NULL, NULL);
+#else
+  tick_id = g_timeout_add (1000 / 60, (GSourceFunc) tick_callback, widget);
+#endif
 }
 
 // Main.
@@ -345,6 +450,26 @@ main (int argc, char **argv)
       _exit (0);
     }
 
+  // Precompile each NCL file, one after another.
+  if (opt_precompile)
+    {
+      int fail_count = 0;
+      opts.width = opt_width;
+      opts.height = opt_height;
+      for (int i = 1; i < saved_argc; i++)
+        {
+          string errmsg;
+          if (unlikely (!Ginga::precompile (string (saved_argv[i]), &opts,
+                                            &errmsg)))
+            {
+              error ("%s: %s", saved_argv[i], errmsg.c_str ());
+              fail_count++;
+            }
+        }
+      g_strfreev (saved_argv);
+      _exit (fail_count);
+    }
+
   if (opt_opengl)
     {
 #if !(defined WITH_OPENGL && WITH_OPENGL)
@@ -391,12 +516,6 @@ main (int argc, char **argv)
   g_signal_connect (app, "key-release-event",
                     G_CALLBACK (keyboard_callback),
                     deconst (void *, "release"));
-#if GTK_CHECK_VERSION(3, 8, 0)
-  gtk_widget_add_tick_callback (app, (GtkTickCallback) tick_callback, NULL,
-                                NULL);
-#else
-  g_timeout_add (1000 / 60, (GSourceFunc) tick_callback, app);
-#endif
 
   // Create Ginga handle.
   opts.width = opt_width;
@@ -405,8 +524,14 @@ main (int argc, char **argv)
   opts.experimental = opt_experimental;
   opts.opengl = opt_opengl;
   opts.background = string (opt_background);
+  opts.imageCacheSize = opt_image_cache;
+  opts.syncImageDecode = false;
+  opts.streamingParse = opt_streaming;
+  opts.backgroundParse = opt_bg_parse;
+  opts.scaleVideo = opt_scale_video;
   GINGA = Ginga::create (&opts);
   g_assert_nonnull (GINGA);
+  Ginga::setWakeupCallback (ginga_wakeup, app);
 
   // Run each NCL file, one after another.
   int fail_count = 0;
@@ -423,6 +548,7 @@ main (int argc, char **argv)
           continue;
         }
       gtk_widget_show_all (app);
+      start_ticking (app);
       gtk_main ();
       GINGA->stop ();
     }
@@ -0,0 +1,154 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+// Benchmark of predicate evaluators.
+//
+// Generates random rule sets over numeric and string properties and
+// evaluates each rule with both Document::evalPredicateTree() and
+// Document::evalPredicate(), checking that they agree.
+//
+// Usage: bench-Document-evalPredicate [RULES [DEPTH [ROUNDS]]]
+
+#include "tests.h"
+
+#define NPROPS 32
+
+static string
+random_operand (GRand *rand)
+{
+  if (g_rand_boolean (rand))
+    return xstrbuild ("$__settings__.p%d",
+                      g_rand_int_range (rand, 0, NPROPS));
+  else if (g_rand_boolean (rand))
+    return xstrbuild ("%d", g_rand_int_range (rand, 0, 100));
+  else
+    return xstrbuild ("s%d", g_rand_int_range (rand, 0, 10));
+}
+
+static Predicate *
+random_predicate (GRand *rand, int depth)
+{
+  Predicate *pred;
+  Predicate::Type type;
+  int i, n;
+
+  if (depth <= 0)
+    {
+      pred = new Predicate (Predicate::ATOM);
+      pred->setTest (
+          random_operand (rand),
+          (Predicate::Test) g_rand_int_range (rand, Predicate::EQ,
+                                              Predicate::GE + 1),
+          random_operand (rand));
+      return pred;
+    }
+
+  switch (g_rand_int_range (rand, 0, 5))
+    {
+    case 0:
+      type = Predicate::NEGATION;
+      n = 1;
+      break;
+    case 1:
+    case 2:
+      type = Predicate::CONJUNCTION;
+      n = g_rand_int_range (rand, 2, 5);
+      break;
+    default:
+      type = Predicate::DISJUNCTION;
+      n = g_rand_int_range (rand, 2, 5);
+      break;
+    }
+
+  pred = new Predicate (type);
+  for (i = 0; i < n; i++)
+    pred->addChild (random_predicate (rand, depth - 1));
+  return pred;
+}
+
+int
+main (int argc, char **argv)
+{
+  Document *doc;
+  Context *root;
+  MediaSettings *settings;
+  vector<Predicate *> rules;
+  GRand *rand;
+  int nrules, depth, rounds;
+  int i, r, ntrue;
+  gint64 t0, t_tree, t_compiled;
+
+  nrules = (argc > 1) ? (int) g_ascii_strtoll (argv[1], NULL, 10) : 1000;
+  depth = (argc > 2) ? (int) g_ascii_strtoll (argv[2], NULL, 10) : 3;
+  rounds = (argc > 3) ? (int) g_ascii_strtoll (argv[3], NULL, 10) : 100;
+
+  tests_create_document (&doc, &root, &settings);
+  rand = g_rand_new_with_seed (0);
+
+  // Even properties are numeric, odd properties are strings.
+  for (i = 0; i < NPROPS; i++)
+    {
+      string value;
+      if (i % 2 == 0)
+        value = xstrbuild ("%d", g_rand_int_range (rand, 0, 100));
+      else
+        value = xstrbuild ("s%d", g_rand_int_range (rand, 0, 10));
+      settings->setProperty (xstrbuild ("p%d", i), value, 0);
+    }
+
+  for (i = 0; i < nrules; i++)
+    rules.push_back (random_predicate (rand, depth));
+
+  // Check that evaluators agree (this also compiles the rules).
+  ntrue = 0;
+  for (auto pred : rules)
+    {
+      bool result = doc->evalPredicateTree (pred);
+      g_assert (result == doc->evalPredicate (pred));
+      if (result)
+        ntrue++;
+    }
+
+  t0 = g_get_monotonic_time ();
+  for (r = 0; r < rounds; r++)
+    for (auto pred : rules)
+      doc->evalPredicateTree (pred);
+  t_tree = g_get_monotonic_time () - t0;
+
+  t0 = g_get_monotonic_time ();
+  for (r = 0; r < rounds; r++)
+    for (auto pred : rules)
+      doc->evalPredicate (pred);
+  t_compiled = g_get_monotonic_time () - t0;
+
+  g_print ("rules: %d, depth: %d, rounds: %d, true: %d\n", nrules, depth,
+           rounds, ntrue);
+  g_print ("tree:     %8" G_GINT64_FORMAT " us (%.1f ns/eval)\n", t_tree,
+           1000. * (double) t_tree / ((double) nrules * rounds));
+  g_print ("compiled: %8" G_GINT64_FORMAT " us (%.1f ns/eval)\n",
+           t_compiled,
+           1000. * (double) t_compiled / ((double) nrules * rounds));
+  g_print ("speedup:  %.2fx\n",
+           (double) t_tree / (double) MAX (t_compiled, 1));
+
+  for (auto pred : rules)
+    delete pred;
+  g_rand_free (rand);
+  delete doc;
+
+  exit (EXIT_SUCCESS);
+}
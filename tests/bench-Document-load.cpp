@@ -0,0 +1,104 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+// Benchmark of document loading.
+//
+// Parses generated documents with N objects, half of them media objects
+// and half of them <media refer> aliases of those, spread over contexts
+// of 100 children each, and reports the parsing time for each N.
+//
+// Usage: bench-Document-load [N...]  (default: 1000 10000 50000)
+
+#include "tests.h"
+
+#define CONTEXT_SIZE 100
+
+static string
+generate_document (int n)
+{
+  string buf;
+  int i, nmedia;
+
+  nmedia = MAX (n / 2, 1);
+  buf = "<ncl>\n<body>\n";
+  buf += "<port id='p' component='c0'/>\n";
+  for (i = 0; i < n; i++)
+    {
+      if (i % CONTEXT_SIZE == 0)
+        {
+          if (i > 0)
+            buf += "</context>\n";
+          buf += xstrbuild ("<context id='c%d'>\n", i / CONTEXT_SIZE);
+        }
+      if (i < nmedia)
+        buf += xstrbuild ("<media id='m%d'/>\n", i);
+      else
+        buf += xstrbuild ("<media id='r%d' refer='m%d'/>\n", i,
+                          (i * 7919) % nmedia);
+    }
+  if (n > 0)
+    buf += "</context>\n";
+  buf += "</body>\n</ncl>\n";
+  return buf;
+}
+
+static void
+bench (int n)
+{
+  Document *doc;
+  string buf;
+  string errmsg;
+  gint64 t0, dt;
+
+  buf = generate_document (n);
+
+  t0 = g_get_monotonic_time ();
+  doc = Parser::parseBuffer (buf.c_str (), buf.length (), 100, 100,
+                             &errmsg);
+  dt = g_get_monotonic_time () - t0;
+
+  if (doc == nullptr)
+    {
+      g_printerr ("*** Unexpected error: %s\n", errmsg.c_str ());
+      g_assert_not_reached ();
+    }
+
+  g_print ("objects: %6d, parse: %10" G_GINT64_FORMAT " us (%.2f us/obj)\n",
+           n, dt, (double) dt / MAX (n, 1));
+
+  delete doc;
+}
+
+int
+main (int argc, char **argv)
+{
+  int i;
+
+  if (argc > 1)
+    {
+      for (i = 1; i < argc; i++)
+        bench ((int) g_ascii_strtoll (argv[i], NULL, 10));
+    }
+  else
+    {
+      bench (1000);
+      bench (10000);
+      bench (50000);
+    }
+
+  exit (EXIT_SUCCESS);
+}
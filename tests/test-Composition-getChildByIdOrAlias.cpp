@@ -0,0 +1,70 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  Document *doc;
+  Context *root;
+  MediaSettings *settings;
+  Context *ctx;
+  Media *m1, *m2, *m3;
+
+  tests_create_document (&doc, &root, &settings);
+
+  ctx = new Context ("ctx");
+  root->addChild (ctx);
+  g_assert (root->getChildById ("ctx") == ctx);
+  g_assert (root->getChildByIdOrAlias ("ctx") == ctx);
+
+  // Alias added before object is a child.
+  m1 = new Media ("m1");
+  m1->addAlias ("a1");
+  ctx->addChild (m1);
+  g_assert (ctx->getChildById ("m1") == m1);
+  g_assert (ctx->getChildByIdOrAlias ("m1") == m1);
+  g_assert (ctx->getChildByIdOrAlias ("a1") == m1);
+  g_assert_null (ctx->getChildById ("a1"));
+  g_assert (doc->getObjectByIdOrAlias ("a1") == m1);
+
+  // Alias added after object is a child.
+  m2 = new Media ("m2");
+  ctx->addChild (m2);
+  g_assert_null (ctx->getChildByIdOrAlias ("a2"));
+  m2->addAlias ("a2", root);
+  g_assert (ctx->getChildByIdOrAlias ("a2") == m2);
+  g_assert (doc->getObjectByIdOrAlias ("a2") == m2);
+
+  // First object to get an alias keeps it.
+  m3 = new Media ("m3");
+  ctx->addChild (m3);
+  m3->addAlias ("a1");
+  g_assert (ctx->getChildByIdOrAlias ("a1") == m1);
+  g_assert (doc->getObjectByIdOrAlias ("a1") == m1);
+
+  // Grandchildren are not children.
+  g_assert_null (root->getChildById ("m1"));
+  g_assert_null (root->getChildByIdOrAlias ("a1"));
+  g_assert_null (ctx->getChildByIdOrAlias ("ctx"));
+  g_assert_cmpint (ctx->getChildren ()->size (), ==, 3);
+
+  delete doc;
+
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,91 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+static Action
+tests_action (Event *evt, Event::Transition trans)
+{
+  Action act;
+
+  act.event = evt;
+  act.transition = trans;
+  act.predicate = nullptr;
+  return act;
+}
+
+int
+main (void)
+{
+  Document *doc;
+  Context *root;
+  MediaSettings *settings;
+  const vector<pair<const Action *, const list<Action> *> > *triggers;
+
+  tests_create_document (&doc, &root, &settings);
+
+  Media *m1 = new Media ("m1");
+  root->addChild (m1);
+  Media *m2 = new Media ("m2");
+  root->addChild (m2);
+  Media *m3 = new Media ("m3");
+  root->addChild (m3);
+
+  Event *e1 = m1->getLambda ();
+  Event *e2 = m2->getLambda ();
+  Event *e3 = m3->getLambda ();
+
+  g_assert_null (root->getLinksByCondition (e1, Event::START));
+
+  // onBegin m1 start m2
+  root->addLink ({ tests_action (e1, Event::START) },
+                 { tests_action (e2, Event::START) });
+
+  // onBegin m1 or onEnd m2 start m3
+  root->addLink ({ tests_action (e1, Event::START),
+                   tests_action (e2, Event::STOP) },
+                 { tests_action (e3, Event::START) });
+
+  g_assert_cmpint (root->getLinks ()->size (), ==, 2);
+
+  triggers = root->getLinksByCondition (e1, Event::START);
+  g_assert_nonnull (triggers);
+  g_assert_cmpint (triggers->size (), ==, 2);
+  g_assert (triggers->at (0).first->event == e1);
+  g_assert (triggers->at (0).second->front ().event == e2);
+  g_assert (triggers->at (1).first->event == e1);
+  g_assert (triggers->at (1).second->front ().event == e3);
+
+  triggers = root->getLinksByCondition (e2, Event::STOP);
+  g_assert_nonnull (triggers);
+  g_assert_cmpint (triggers->size (), ==, 1);
+  g_assert (triggers->at (0).first->transition == Event::STOP);
+  g_assert (triggers->at (0).second->front ().event == e3);
+
+  // Conditions are indexed by event and transition.
+  g_assert_null (root->getLinksByCondition (e1, Event::STOP));
+  g_assert_null (root->getLinksByCondition (e2, Event::START));
+  g_assert_null (root->getLinksByCondition (e3, Event::START));
+
+  // Indexed entries point into the stored links.
+  triggers = root->getLinksByCondition (e2, Event::STOP);
+  g_assert (triggers->at (0).second == &root->getLinks ()->back ().second);
+
+  delete doc;
+
+  exit (EXIT_SUCCESS);
+}
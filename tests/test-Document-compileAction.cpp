@@ -0,0 +1,95 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  Document *doc;
+  Context *root;
+  MediaSettings *settings;
+  Action act;
+
+  tests_create_document (&doc, &root, &settings);
+
+  Media *m1 = new Media ("m1");
+  root->addChild (m1);
+  m1->setProperty ("p", "a");
+  root->addAttributionEvent ("x");
+  Event *x = root->getAttributionEvent ("x");
+  g_assert_nonnull (x);
+
+  act.event = x;
+  act.transition = Event::START;
+  act.predicate = nullptr;
+  act.value = "$m1.p";
+  act.duration = "";
+  act.delay = "1.5s";
+
+  // Actions built by hand are not compiled.
+  g_assert_false (act.valueParam.compiled);
+  g_assert_false (act.durationParam.compiled);
+  g_assert_false (act.delayParam.compiled);
+
+  doc->compileAction (&act);
+
+  // Property references are resolved.
+  g_assert_true (act.valueParam.compiled);
+  g_assert (act.valueParam.object == m1);
+  g_assert (act.valueParam.name == "p");
+
+  // Literal times are parsed.
+  g_assert_true (act.durationParam.compiled);
+  g_assert_null (act.durationParam.object);
+  g_assert_cmpint (act.durationParam.time, ==, 0);
+  g_assert_true (act.delayParam.compiled);
+  g_assert_null (act.delayParam.object);
+  g_assert_cmpint (act.delayParam.time, ==, 1500 * GINGA_MSECOND);
+
+  // The source text is kept.
+  g_assert (act.value == "$m1.p");
+  g_assert (act.delay == "1.5s");
+
+  // References are evaluated when the action is fired.
+  g_assert_cmpint (doc->evalAction (act), ==, 1);
+  g_assert (root->getProperty ("x") == "a");
+  g_assert (x->getAttributionValue () == "a");
+  g_assert_cmpint (x->getAttributionDuration (), ==, 0);
+  g_assert_cmpint (doc->evalAction (x, Event::STOP), ==, 1);
+
+  m1->setProperty ("p", "b");
+  g_assert_cmpint (doc->evalAction (act), ==, 1);
+  g_assert (root->getProperty ("x") == "b");
+  g_assert_cmpint (doc->evalAction (x, Event::STOP), ==, 1);
+
+  // Unresolved references and other strings are kept as literals.
+  act.value = "$m2.p";
+  act.delay = "abc";
+  doc->compileAction (&act);
+  g_assert_null (act.valueParam.object);
+  g_assert_cmpint (act.valueParam.time, ==, GINGA_TIME_NONE);
+  g_assert_null (act.delayParam.object);
+  g_assert_cmpint (act.delayParam.time, ==, GINGA_TIME_NONE);
+
+  g_assert_cmpint (doc->evalAction (act), ==, 1);
+  g_assert (root->getProperty ("x") == "$m2.p");
+
+  delete doc;
+
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,140 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  // Numeric operands are compared as numbers.
+  {
+    Document *doc;
+    Context *root;
+    MediaSettings *settings;
+    Predicate *pred;
+
+    tests_create_document (&doc, &root, &settings);
+    settings->setProperty ("x", "10", 0);
+    settings->setProperty ("y", "9.5", 0);
+    settings->setProperty ("z", "10px", 0);
+
+    pred = new Predicate (Predicate::ATOM);
+
+    // 10 > 9.5 -> true (as strings, "10" < "9.5")
+    pred->setTest ("$__settings__.x", Predicate::GT, "$__settings__.y");
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+
+    // 10 == 10.0 -> true
+    pred->setTest ("$__settings__.x", Predicate::EQ, "10.0");
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+
+    // 10 < 100 -> true
+    pred->setTest ("$__settings__.x", Predicate::LT, "100");
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+
+    // '10px' is not a number: '10px' < '9' -> true
+    pred->setTest ("$__settings__.z", Predicate::LT, "9");
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+
+    // '10px' != 10 -> true
+    pred->setTest ("$__settings__.z", Predicate::NE, "10");
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+
+    delete pred;
+    delete doc;
+  }
+
+  // Compiled predicate sees property changes.
+  {
+    Document *doc;
+    Context *root;
+    MediaSettings *settings;
+    Predicate *pred;
+
+    tests_create_document (&doc, &root, &settings);
+    settings->setProperty ("x", "1", 0);
+
+    pred = new Predicate (Predicate::ATOM);
+    pred->setTest ("$__settings__.x", Predicate::GE, "2");
+    g_assert_false (doc->evalPredicate (pred));
+    g_assert_nonnull (pred->getProgram ());
+
+    settings->setProperty ("x", "2", 0);
+    g_assert (doc->evalPredicate (pred));
+
+    delete pred;
+    delete doc;
+  }
+
+  // Compiled predicate is discarded when a child changes.
+  {
+    Document *doc;
+    Context *root;
+    MediaSettings *settings;
+    Predicate *pred;
+    Predicate *atom;
+
+    tests_create_document (&doc, &root, &settings);
+    settings->setProperty ("x", "1", 0);
+
+    atom = new Predicate (Predicate::ATOM);
+    atom->setTest ("$__settings__.x", Predicate::EQ, "1");
+    pred = new Predicate (Predicate::CONJUNCTION);
+    pred->addChild (atom);
+    pred->addChild (new Predicate (Predicate::VERUM));
+    g_assert (doc->evalPredicate (pred));
+    g_assert_nonnull (pred->getProgram ());
+
+    atom->setTest ("$__settings__.x", Predicate::EQ, "2");
+    g_assert_null (pred->getProgram ());
+    g_assert_false (doc->evalPredicate (pred));
+
+    delete pred;
+    delete doc;
+  }
+
+  // Unresolved references are resolved when evaluated.
+  {
+    Document *doc;
+    Context *root;
+    MediaSettings *settings;
+    Predicate *pred;
+    Media *m;
+
+    tests_create_document (&doc, &root, &settings);
+
+    pred = new Predicate (Predicate::ATOM);
+    pred->setTest ("$m.x", Predicate::EQ, "1");
+    g_assert_false (doc->evalPredicate (pred));
+
+    m = new Media ("m");
+    root->addChild (m);
+    m->setProperty ("x", "1", 0);
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+
+    delete pred;
+    delete doc;
+  }
+
+  exit (EXIT_SUCCESS);
+}
@@ -100,13 +100,81 @@ main (void)
   }
 
   // Document:evalPredicate NEGATION
-  {}
+  {
+    Document *doc;
+    Context *root;
+    MediaSettings *settings;
+    Predicate *pred;
+
+    tests_create_document (&doc, &root, &settings);
+
+    pred = new Predicate (Predicate::NEGATION);
+    pred->addChild (new Predicate (Predicate::FALSUM));
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+    delete pred;
+
+    pred = new Predicate (Predicate::NEGATION);
+    pred->addChild (new Predicate (Predicate::VERUM));
+    g_assert_false (doc->evalPredicate (pred));
+    g_assert_false (doc->evalPredicateTree (pred));
+    delete pred;
+
+    delete doc;
+  }
 
   // Document:evalPredicate CONJUNCTION
-  {}
+  {
+    Document *doc;
+    Context *root;
+    MediaSettings *settings;
+    Predicate *pred;
+
+    tests_create_document (&doc, &root, &settings);
+
+    // and() -> true
+    pred = new Predicate (Predicate::CONJUNCTION);
+    g_assert (doc->evalPredicate (pred));
+
+    // and(true, true) -> true
+    pred->addChild (new Predicate (Predicate::VERUM));
+    pred->addChild (new Predicate (Predicate::VERUM));
+    g_assert (doc->evalPredicate (pred));
+
+    // and(true, true, false) -> false
+    pred->addChild (new Predicate (Predicate::FALSUM));
+    g_assert_false (doc->evalPredicate (pred));
+    g_assert_false (doc->evalPredicateTree (pred));
+    delete pred;
+
+    delete doc;
+  }
 
   // Document:evalPredicate DISJUNCTION
   {
+    Document *doc;
+    Context *root;
+    MediaSettings *settings;
+    Predicate *pred;
+
+    tests_create_document (&doc, &root, &settings);
+
+    // or() -> false
+    pred = new Predicate (Predicate::DISJUNCTION);
+    g_assert_false (doc->evalPredicate (pred));
+
+    // or(false, false) -> false
+    pred->addChild (new Predicate (Predicate::FALSUM));
+    pred->addChild (new Predicate (Predicate::FALSUM));
+    g_assert_false (doc->evalPredicate (pred));
+
+    // or(false, false, true) -> true
+    pred->addChild (new Predicate (Predicate::VERUM));
+    g_assert (doc->evalPredicate (pred));
+    g_assert (doc->evalPredicateTree (pred));
+    delete pred;
+
+    delete doc;
   }
 
   exit (EXIT_SUCCESS);
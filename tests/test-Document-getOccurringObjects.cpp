@@ -0,0 +1,120 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  Formatter *fmt;
+  Document *doc;
+  ObjectList *awake;
+  ObjectList *occurring;
+  size_t n;
+
+  tests_parse_and_start (&fmt, &doc, "\
+<ncl>\n\
+<body>\n\
+  <port id='p1' component='m1'/>\n\
+  <port id='p2' component='m2'/>\n\
+  <media id='m1'/>\n\
+  <media id='m2'/>\n\
+  <media id='m3'/>\n\
+</body>\n\
+</ncl>\n");
+
+  Context *body = cast (Context *, doc->getRoot ());
+  g_assert_nonnull (body);
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+  Media *m2 = cast (Media *, doc->getObjectById ("m2"));
+  g_assert_nonnull (m2);
+  Media *m3 = cast (Media *, doc->getObjectById ("m3"));
+  g_assert_nonnull (m3);
+
+  awake = doc->getAwakeObjects ();
+  g_assert_nonnull (awake);
+  occurring = doc->getOccurringObjects ();
+  g_assert_nonnull (occurring);
+
+  // Only the root and the settings object are active after start.
+  g_assert (occurring->contains (body));
+  g_assert (occurring->contains (doc->getSettings ()));
+  g_assert_false (occurring->contains (m1));
+  g_assert_false (occurring->contains (m2));
+  g_assert_false (awake->contains (m3));
+  n = occurring->size ();
+  g_assert_cmpint (awake->size (), ==, n);
+
+  // Ports are started in the next tick.
+  fmt->sendTick (0, 0, 0);
+  g_assert (occurring->contains (m1));
+  g_assert (occurring->contains (m2));
+  g_assert_false (awake->contains (m3));
+  g_assert_cmpint (occurring->size (), ==, n + 2);
+  g_assert_cmpint (awake->size (), ==, n + 2);
+
+  // Paused objects are awake but not occurring.
+  g_assert (doc->evalAction (m1->getLambda (), Event::PAUSE) > 0);
+  g_assert (awake->contains (m1));
+  g_assert_false (occurring->contains (m1));
+  g_assert_cmpint (occurring->size (), ==, n + 1);
+  g_assert_cmpint (awake->size (), ==, n + 2);
+
+  g_assert (doc->evalAction (m1->getLambda (), Event::RESUME) > 0);
+  g_assert (occurring->contains (m1));
+  g_assert_cmpint (occurring->size (), ==, n + 2);
+
+  // Stopped objects leave both lists.
+  g_assert (doc->evalAction (m2->getLambda (), Event::STOP) > 0);
+  g_assert_false (awake->contains (m2));
+  g_assert_false (occurring->contains (m2));
+  g_assert_cmpint (occurring->size (), ==, n + 1);
+  g_assert_cmpint (awake->size (), ==, n + 1);
+
+  // Objects removed during a walk are not visited; objects inserted during
+  // a walk are visited only by the next walk.
+  size_t visited = 0;
+  for (Object *obj = occurring->walkFirst (); obj != nullptr;
+       obj = occurring->walkNext ())
+    {
+      g_assert (obj != m1);
+      g_assert (obj != m3);
+      if (obj == body || obj == doc->getSettings ())
+        {
+          if (occurring->contains (m1))
+            g_assert (doc->evalAction (m1->getLambda (), Event::STOP) > 0);
+          if (!occurring->contains (m3))
+            g_assert (doc->evalAction (m3->getLambda (), Event::START)
+                      > 0);
+        }
+      visited++;
+    }
+  g_assert_cmpint (visited, <=, n);
+  g_assert_false (occurring->contains (m1));
+  g_assert (occurring->contains (m3));
+
+  visited = 0;
+  for (Object *obj = occurring->walkFirst (); obj != nullptr;
+       obj = occurring->walkNext ())
+    visited++;
+  g_assert_cmpint (visited, ==, occurring->size ());
+
+  delete fmt;
+
+  exit (EXIT_SUCCESS);
+}
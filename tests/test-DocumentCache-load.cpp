@@ -0,0 +1,154 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+#include "DocumentCache.h"
+
+int
+main (void)
+{
+  Document *doc;
+  string base, file, errmsg;
+
+  base = tests_write_tmp_file ("\
+<ncl>\n\
+ <head>\n\
+  <connectorBase>\n\
+   <causalConnector id='onBeginStart'>\n\
+    <simpleCondition role='onBegin'/>\n\
+    <simpleAction role='start'/>\n\
+   </causalConnector>\n\
+  </connectorBase>\n\
+ </head>\n\
+</ncl>\n");
+
+  file = tests_write_tmp_file ("\
+<ncl id='doc'>\n\
+ <head>\n\
+  <regionBase>\n\
+   <region id='r' left='25%'/>\n\
+  </regionBase>\n\
+  <descriptorBase>\n\
+   <descriptor id='d' region='r'/>\n\
+  </descriptorBase>\n\
+  <connectorBase>\n\
+   <importBase alias='x' documentURI='" + base + "'/>\n\
+  </connectorBase>\n\
+  <ruleBase>\n\
+   <rule id='r1' var='v' comparator='eq' value='1'/>\n\
+  </ruleBase>\n\
+ </head>\n\
+ <body>\n\
+  <port id='p' component='m1'/>\n\
+  <media id='m1' descriptor='d'>\n\
+   <area id='a1' begin='1s' end='2s'/>\n\
+   <property name='top' value='50%'/>\n\
+  </media>\n\
+  <media id='m3' refer='m1'/>\n\
+  <switch id='s'>\n\
+   <bindRule constituent='m2' rule='r1'/>\n\
+   <media id='m2'/>\n\
+  </switch>\n\
+  <link xconnector='x#onBeginStart'>\n\
+   <bind role='onBegin' component='m1' interface='a1'/>\n\
+   <bind role='start' component='s'/>\n\
+  </link>\n\
+ </body>\n\
+</ncl>\n");
+
+  // No cache yet.
+  g_assert_null (DocumentCache::load (file, 100, 100, &errmsg));
+
+  // Precompile and load.
+  if (!DocumentCache::precompile (file, 100, 100, &errmsg))
+    {
+      g_printerr ("*** Unexpected error: %s", errmsg.c_str ());
+      g_assert_not_reached ();
+    }
+
+  doc = DocumentCache::load (file, 100, 100, &errmsg);
+  if (doc == nullptr)
+    {
+      g_printerr ("*** Unexpected error: %s", errmsg.c_str ());
+      g_assert_not_reached ();
+    }
+
+  Context *root = doc->getRoot ();
+  g_assert_nonnull (root);
+  g_assert (root->hasAlias ("doc"));
+  g_assert (root->getPorts ()->size () == 1);
+  g_assert (root->getLinks ()->size () == 1);
+
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+  g_assert (m1->getParent () == root);
+  g_assert (doc->getObjectByIdOrAlias ("m3") == m1);
+  g_assert (root->getChildByIdOrAlias ("m3") == m1);
+  g_assert (doubleeq (xstrtodorpercent (m1->getProperty ("left"), nullptr),
+                      .25));
+  g_assert (doubleeq (xstrtodorpercent (m1->getProperty ("top"), nullptr),
+                      .5));
+
+  Event *a1 = m1->getPresentationEvent ("a1");
+  g_assert_nonnull (a1);
+  Time begin, end;
+  a1->getInterval (&begin, &end);
+  g_assert_cmpuint (begin, ==, 1 * GINGA_SECOND);
+  g_assert_cmpuint (end, ==, 2 * GINGA_SECOND);
+
+  Switch *s = cast (Switch *, doc->getObjectById ("s"));
+  g_assert_nonnull (s);
+  g_assert (s->getRules ()->size () == 1);
+  g_assert (s->getRules ()->front ().first == doc->getObjectById ("m2"));
+  g_assert (s->getRules ()->front ().second->getType ()
+            == Predicate::ATOM);
+
+  auto &link = root->getLinks ()->front ();
+  g_assert (link.first.size () == 1);
+  g_assert (link.first.front ().event == a1);
+  g_assert (link.second.size () == 1);
+  g_assert (link.second.front ().event == s->getLambda ());
+
+  delete doc;
+
+  // Stale: different screen size.
+  g_assert_null (DocumentCache::load (file, 200, 100, &errmsg));
+
+  // Fresh: imported document rewritten with the same contents.
+  {
+    gchar *data;
+    gsize len;
+    g_assert (g_file_get_contents (base.c_str (), &data, &len, nullptr));
+    g_usleep (10000);
+    g_assert (g_file_set_contents (base.c_str (), data, (gssize) len,
+                                   nullptr));
+    g_free (data);
+  }
+  doc = DocumentCache::load (file, 100, 100, &errmsg);
+  g_assert_nonnull (doc);
+  delete doc;
+
+  // Stale: imported document changed.
+  g_assert (g_file_set_contents (base.c_str (), "<ncl/>", -1, nullptr));
+  g_assert_null (DocumentCache::load (file, 100, 100, &errmsg));
+
+  g_remove (DocumentCache::getPath (file).c_str ());
+  g_remove (file.c_str ());
+  g_remove (base.c_str ());
+
+  exit (EXIT_SUCCESS);
+}
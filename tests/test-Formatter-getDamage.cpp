@@ -0,0 +1,110 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  Formatter *fmt;
+  Document *doc;
+  cairo_surface_t *sfc;
+  cairo_region_t *damage;
+  cairo_t *cr;
+  Rect rect;
+
+  tests_parse_and_start (&fmt, &doc, "\
+<ncl>\n\
+  <body>\n\
+    <port id='p1' component='m1'/>\n\
+    <media id='m1'>\n\
+      <property name='background' value='red'/>\n\
+      <property name='left' value='0'/>\n\
+      <property name='top' value='0'/>\n\
+      <property name='width' value='100'/>\n\
+      <property name='height' value='100'/>\n\
+    </media>\n\
+  </body>\n\
+</ncl>\n");
+
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+
+  sfc = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 800, 600);
+  g_assert_nonnull (sfc);
+  cr = cairo_create (sfc);
+  g_assert_nonnull (cr);
+
+  // After start, the whole screen is damaged.
+  damage = cairo_region_create ();
+  g_assert_true (fmt->getDamage (damage));
+  rect = { 0, 0, 800, 600 };
+  g_assert (cairo_region_contains_rectangle (damage, &rect)
+            == CAIRO_REGION_OVERLAP_IN);
+  cairo_region_destroy (damage);
+
+  // Redrawing the whole screen clears the damage.
+  fmt->sendTick (0, 0, 0);
+  g_assert (m1->isOccurring ());
+  fmt->redraw (cr);
+  g_assert_false (fmt->getDamage (nullptr));
+
+  // Nothing changed, nothing is damaged.
+  fmt->sendTick (1 * GINGA_SECOND, 1 * GINGA_SECOND, 1);
+  g_assert_false (fmt->getDamage (nullptr));
+
+  // Moving m1 damages its old and new areas only.
+  m1->setProperty ("left", "200");
+  damage = cairo_region_create ();
+  g_assert_true (fmt->getDamage (damage));
+  rect = { 0, 0, 100, 100 };
+  g_assert (cairo_region_contains_rectangle (damage, &rect)
+            == CAIRO_REGION_OVERLAP_IN);
+  rect = { 200, 0, 100, 100 };
+  g_assert (cairo_region_contains_rectangle (damage, &rect)
+            == CAIRO_REGION_OVERLAP_IN);
+  rect = { 400, 300, 100, 100 };
+  g_assert (cairo_region_contains_rectangle (damage, &rect)
+            == CAIRO_REGION_OVERLAP_OUT);
+  cairo_region_destroy (damage);
+
+  // Redrawing outside the damaged area keeps it pending.
+  cairo_save (cr);
+  cairo_rectangle (cr, 400, 300, 100, 100);
+  cairo_clip (cr);
+  fmt->redraw (cr);
+  cairo_restore (cr);
+  g_assert_true (fmt->getDamage (nullptr));
+
+  fmt->redraw (cr);
+  g_assert_false (fmt->getDamage (nullptr));
+
+  // Stopping m1 damages its last area.
+  g_assert (m1->getLambda ()->transition (Event::STOP));
+  damage = cairo_region_create ();
+  g_assert_true (fmt->getDamage (damage));
+  rect = { 200, 0, 100, 100 };
+  g_assert (cairo_region_contains_rectangle (damage, &rect)
+            == CAIRO_REGION_OVERLAP_IN);
+  cairo_region_destroy (damage);
+
+  cairo_destroy (cr);
+  cairo_surface_destroy (sfc);
+  delete fmt;
+
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,107 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+static void
+check_sorted (const vector<Player *> *list)
+{
+  int last_zindex = G_MININT;
+  int last_zorder = G_MININT;
+
+  for (auto player : *list)
+    {
+      int zindex, zorder;
+
+      g_assert (player->getState () != Player::SLEEPING);
+      player->getZ (&zindex, &zorder);
+      g_assert (zindex > last_zindex
+                || (zindex == last_zindex && zorder >= last_zorder));
+      last_zindex = zindex;
+      last_zorder = zorder;
+    }
+}
+
+int
+main (void)
+{
+  Formatter *fmt;
+  Document *doc;
+  const vector<Player *> *list;
+  int zindex;
+
+  tests_parse_and_start (&fmt, &doc, "\
+<ncl>\n\
+  <body>\n\
+    <port id='p1' component='m1'/>\n\
+    <port id='p2' component='m2'/>\n\
+    <port id='p3' component='m3'/>\n\
+    <media id='m1'>\n\
+      <property name='zIndex' value='3'/>\n\
+    </media>\n\
+    <media id='m2'>\n\
+      <property name='zIndex' value='1'/>\n\
+    </media>\n\
+    <media id='m3'>\n\
+      <property name='zIndex' value='2'/>\n\
+    </media>\n\
+  </body>\n\
+</ncl>\n");
+
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+  Media *m2 = cast (Media *, doc->getObjectById ("m2"));
+  g_assert_nonnull (m2);
+
+  list = fmt->getDisplayList ();
+  g_assert_nonnull (list);
+
+  // Only the settings player is in display list.
+  g_assert_cmpint (list->size (), ==, 1);
+
+  // When media objects start, their players are inserted in z order.
+  fmt->sendTick (0, 0, 0);
+  g_assert (m1->isOccurring ());
+  g_assert (m2->isOccurring ());
+  g_assert_cmpint (list->size (), ==, 4);
+  check_sorted (list);
+  list->back ()->getZ (&zindex, nullptr);
+  g_assert_cmpint (zindex, ==, 3);
+
+  // Changing the z-index of a player moves it in display list.
+  m2->setProperty ("zIndex", "5");
+  g_assert_cmpint (list->size (), ==, 4);
+  check_sorted (list);
+  list->back ()->getZ (&zindex, nullptr);
+  g_assert_cmpint (zindex, ==, 5);
+
+  // Stopping a media object removes its player from display list.
+  g_assert (m2->getLambda ()->transition (Event::STOP));
+  g_assert (m2->isSleeping ());
+  g_assert_cmpint (list->size (), ==, 3);
+  check_sorted (list);
+  list->back ()->getZ (&zindex, nullptr);
+  g_assert_cmpint (zindex, ==, 3);
+
+  // Stopping the formatter empties display list.
+  g_assert (fmt->stop ());
+  g_assert_cmpint (list->size (), ==, 0);
+
+  delete fmt;
+
+  exit (EXIT_SUCCESS);
+}
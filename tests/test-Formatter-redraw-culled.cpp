@@ -0,0 +1,81 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+#include "PlayerImage.h"
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options ();
+  PlayerImageCacheStats stats;
+  cairo_surface_t *screen;
+  cairo_t *cr;
+  Formatter *fmt;
+  Media *m1;
+  string png, file, errmsg;
+
+  png = tests_write_tmp_png (64, 32, 0xffff0000, 0xffff0000);
+  PlayerImage::clearCache ();
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p1' component='m1'/>\n\
+  <media id='m1' src='%s'>\n\
+   <property name='width' value='16'/>\n\
+   <property name='height' value='8'/>\n\
+  </media>\n\
+ </body>\n\
+</ncl>\n",
+                                           png.c_str ()));
+  fmt = new Formatter (&opts);
+  g_assert_true (fmt->start (file, &errmsg));
+  m1 = cast (Media *, fmt->getDocument ()->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 1);
+
+  screen = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 800, 600);
+  g_assert_nonnull (screen);
+
+  // Players outside the painted area are not drawn, but they are still
+  // updated: m1 is reloaded at its new size.
+  m1->setProperty ("width", "64");
+  m1->setProperty ("height", "32");
+  cr = cairo_create (screen);
+  g_assert_nonnull (cr);
+  cairo_rectangle (cr, 400, 300, 100, 100);
+  cairo_clip (cr);
+  fmt->redraw (cr);
+  cairo_destroy (cr);
+  cairo_surface_flush (screen);
+  g_assert_cmphex (*(guint32 *) cairo_image_surface_get_data (screen), ==,
+                   0);
+
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 2);
+
+  // Once the painted area covers it, m1 is drawn.
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen), ==, 0xffff0000);
+
+  cairo_surface_destroy (screen);
+  delete fmt;
+  g_remove (file.c_str ());
+  g_remove (png.c_str ());
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,82 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+// Ticks the formatter until its document is attached or it stops.
+static void
+tick_until_ready (Formatter *fmt)
+{
+  for (int i = 0; i < 5000; i++)
+    {
+      if (!fmt->sendTick (0, 0, 0) || fmt->getDocument () != nullptr)
+        return;
+      g_usleep (1000);
+    }
+  g_assert_not_reached ();
+}
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options ();
+  Formatter *fmt;
+  Document *doc;
+  string file, errmsg;
+
+  opts.backgroundParse = true;
+  fmt = new Formatter (&opts);
+  g_assert_nonnull (fmt);
+
+  // Start returns before the document is ready.
+  file = tests_write_tmp_file ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p' component='m'/>\n\
+  <media id='m'/>\n\
+ </body>\n\
+</ncl>\n");
+  g_assert_true (fmt->start (file, &errmsg));
+  g_assert (fmt->getState () == GINGA_STATE_PLAYING);
+  g_assert (fmt->getTimeToFirstFrame () == GINGA_TIME_NONE);
+  g_assert_true (fmt->sendKey ("RED", true));
+
+  tick_until_ready (fmt);
+  doc = fmt->getDocument ();
+  g_assert_nonnull (doc);
+  g_assert (doc->getRoot ()->isOccurring ());
+  g_assert (doc->getObjectById ("m")->isOccurring ());
+  g_assert_true (fmt->stop ());
+  g_remove (file.c_str ());
+
+  // Parse errors stop the formatter.
+  file = tests_write_tmp_file ("<ncl><media/></ncl>");
+  g_assert_true (fmt->start (file, &errmsg));
+  tick_until_ready (fmt);
+  g_assert_null (fmt->getDocument ());
+  g_assert (fmt->getState () == GINGA_STATE_STOPPED);
+  g_remove (file.c_str ());
+
+  // Stopping while parsing is safe.
+  file = tests_write_tmp_file ("<ncl/>");
+  g_assert_true (fmt->start (file, &errmsg));
+  g_assert_true (fmt->stop ());
+  g_remove (file.c_str ());
+
+  delete fmt;
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,95 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  Formatter *fmt;
+  Document *doc;
+  cairo_surface_t *sfc;
+  cairo_t *cr;
+  uint64_t delay;
+  bool redraw;
+
+  // Nothing is scheduled while stopped.
+  {
+    Ginga *ginga = Ginga::create (nullptr);
+    g_assert_nonnull (ginga);
+    g_assert_false (ginga->getNextDeadline (&delay, &redraw));
+    g_assert_cmpint (delay, ==, GINGA_TIME_NONE);
+    g_assert_false (redraw);
+    delete ginga;
+  }
+
+  tests_parse_and_start (&fmt, &doc, "\
+<ncl>\n\
+  <body>\n\
+    <port id='p1' component='m1'/>\n\
+    <media id='m1'>\n\
+      <property name='explicitDur' value='3s'/>\n\
+    </media>\n\
+  </body>\n\
+</ncl>\n");
+
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+
+  sfc = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 800, 600);
+  g_assert_nonnull (sfc);
+  cr = cairo_create (sfc);
+  g_assert_nonnull (cr);
+
+  // Ports are started by the next tick.
+  g_assert_true (fmt->getNextDeadline (&delay, &redraw));
+  g_assert_cmpint (delay, ==, 0);
+  g_assert_true (redraw);
+
+  // The next deadline is the end of m1.
+  fmt->sendTick (0, 0, 0);
+  g_assert (m1->isOccurring ());
+  fmt->redraw (cr);
+  g_assert_true (fmt->getNextDeadline (&delay, &redraw));
+  g_assert_cmpint (delay, ==, 3 * GINGA_SECOND + 1);
+  g_assert_false (redraw);
+
+  fmt->sendTick (1 * GINGA_SECOND, 1 * GINGA_SECOND, 1);
+  g_assert_true (fmt->getNextDeadline (&delay, nullptr));
+  g_assert_cmpint (delay, ==, 2 * GINGA_SECOND + 1);
+
+  // Sleeping until the deadline is enough for m1 to end.
+  fmt->sendTick (3 * GINGA_SECOND + 1, delay, 2);
+  g_assert (m1->isSleeping ());
+  g_assert_true (fmt->getNextDeadline (&delay, &redraw));
+  g_assert_cmpint (delay, ==, 0);
+  g_assert_true (redraw);
+
+  // The presentation has ended.
+  while (fmt->getNextDeadline (&delay, nullptr))
+    {
+      g_assert_cmpint (delay, ==, 0);
+      fmt->sendTick (3 * GINGA_SECOND + 1, 0, 3);
+    }
+  g_assert (fmt->getState () == GINGA_STATE_STOPPED);
+
+  cairo_destroy (cr);
+  cairo_surface_destroy (sfc);
+  delete fmt;
+
+  exit (EXIT_SUCCESS);
+}
@@ -29,6 +29,11 @@ main (void)
     false,   // experimental
     false,   // opengl
     "green", // background
+    1024,    // imageCacheSize
+    true,    // syncImageDecode
+    true,    // streamingParse
+    true,    // backgroundParse
+    true,    // scaleVideo
   };
   Ginga *ginga = Ginga::create (&opts);
   g_assert_nonnull (ginga);
@@ -40,6 +45,11 @@ main (void)
   g_assert (out->experimental == opts.experimental);
   g_assert (out->opengl == opts.opengl);
   g_assert (out->background == opts.background);
+  g_assert (out->imageCacheSize == opts.imageCacheSize);
+  g_assert (out->syncImageDecode == opts.syncImageDecode);
+  g_assert (out->streamingParse == opts.streamingParse);
+  g_assert (out->backgroundParse == opts.backgroundParse);
+  g_assert (out->scaleVideo == opts.scaleVideo);
 
   exit (EXIT_SUCCESS);
 }
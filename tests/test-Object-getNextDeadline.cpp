@@ -0,0 +1,87 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  Formatter *fmt;
+  Document *doc;
+
+  tests_parse_and_start (&fmt, &doc, "\
+<ncl>\n\
+<body>\n\
+  <port id='p1' component='m1'/>\n\
+  <media id='m1'/>\n\
+  <media id='m2'/>\n\
+  <media id='m3'/>\n\
+</body>\n\
+</ncl>\n");
+
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+  Media *m2 = cast (Media *, doc->getObjectById ("m2"));
+  g_assert_nonnull (m2);
+  Media *m3 = cast (Media *, doc->getObjectById ("m3"));
+  g_assert_nonnull (m3);
+
+  fmt->sendTick (0, 0, 0);
+  g_assert (m1->isOccurring ());
+  g_assert_cmpint (m1->getNextDeadline (), ==, GINGA_TIME_NONE);
+  g_assert_cmpint (doc->getTimeToNextDeadline (), ==, GINGA_TIME_NONE);
+
+  // Actions are kept in due order, not in scheduling order.
+  m1->addDelayedAction (m2->getLambda (), Event::START, "",
+                        2 * GINGA_SECOND);
+  m1->addDelayedAction (m3->getLambda (), Event::START, "",
+                        1 * GINGA_SECOND);
+  g_assert_cmpint (m1->getDelayedActions ()->size (), ==, 2);
+  g_assert_cmpint (m1->getNextDeadline (), ==,
+                   m1->getTime () + 1 * GINGA_SECOND);
+  g_assert_cmpint (doc->getTimeToNextDeadline (), ==, 1 * GINGA_SECOND);
+
+  // Only due actions are triggered.
+  fmt->sendTick (0, GINGA_SECOND / 2, 0);
+  g_assert (m2->isSleeping ());
+  g_assert (m3->isSleeping ());
+  g_assert_cmpint (doc->getTimeToNextDeadline (), ==, GINGA_SECOND / 2);
+
+  fmt->sendTick (0, GINGA_SECOND / 2, 0);
+  g_assert (m2->isSleeping ());
+  g_assert (m3->isOccurring ());
+  g_assert_cmpint (m1->getDelayedActions ()->size (), ==, 1);
+  g_assert_cmpint (doc->getTimeToNextDeadline (), ==, 1 * GINGA_SECOND);
+
+  fmt->sendTick (0, 1 * GINGA_SECOND, 0);
+  g_assert (m2->isOccurring ());
+  g_assert_cmpint (m1->getDelayedActions ()->size (), ==, 0);
+  g_assert_cmpint (m1->getNextDeadline (), ==, GINGA_TIME_NONE);
+  g_assert_cmpint (doc->getTimeToNextDeadline (), ==, GINGA_TIME_NONE);
+
+  // Pending actions are dropped when the object stops.
+  m1->addDelayedAction (m2->getLambda (), Event::STOP, "",
+                        1 * GINGA_SECOND);
+  g_assert_cmpint (doc->getTimeToNextDeadline (), ==, 1 * GINGA_SECOND);
+  g_assert (doc->evalAction (m1->getLambda (), Event::STOP) > 0);
+  g_assert_cmpint (m1->getDelayedActions ()->size (), ==, 0);
+  g_assert_cmpint (doc->getTimeToNextDeadline (), ==, GINGA_TIME_NONE);
+
+  delete fmt;
+
+  exit (EXIT_SUCCESS);
+}
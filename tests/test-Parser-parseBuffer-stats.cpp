@@ -0,0 +1,80 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+#define N 300
+
+int
+main (void)
+{
+  Document *doc;
+  ParserStats stats;
+  string buf;
+  string msg;
+
+  // Generate N regions, N descriptors, and N media objects, each media
+  // pointing to a descriptor which points to a region.  Descriptors are
+  // declared in reverse order so that lookups do not hit the first cached
+  // element by chance.
+  buf = "<ncl>\n<head>\n<regionBase>\n";
+  for (int i = 0; i < N; i++)
+    buf += xstrbuild ("<region id='r%d' left='%d%%'/>\n", i, i % 100);
+  buf += "</regionBase>\n<descriptorBase>\n";
+  for (int i = N - 1; i >= 0; i--)
+    buf += xstrbuild ("<descriptor id='d%d' region='r%d'/>\n", i, i);
+  buf += "</descriptorBase>\n</head>\n<body>\n";
+  for (int i = 0; i < N; i++)
+    buf += xstrbuild ("<media id='m%d' descriptor='d%d'/>\n", i, i);
+  buf += "</body>\n</ncl>\n";
+
+  doc = Parser::parseBuffer (buf.c_str (), buf.length (), 100, 100, &msg,
+                             &stats);
+  if (doc == nullptr)
+    {
+      g_printerr ("*** Unexpected error: %s", msg.c_str ());
+      g_assert_not_reached ();
+    }
+
+  for (int i = 0; i < N; i++)
+    {
+      Object *m = doc->getObjectById (xstrbuild ("m%d", i));
+      g_assert_nonnull (m);
+      g_assert (doubleeq (xstrtodorpercent (m->getProperty ("left"),
+                                            nullptr),
+                          (i % 100) / 100.));
+    }
+
+  g_assert_cmpint (stats.elements, >=, 3 * N);
+  g_assert_cmpint (stats.cached, >=, 3 * N);
+  g_assert_cmpint (stats.cached, <=, stats.elements);
+  g_assert (stats.total >= stats.read);
+  g_assert (stats.total >= stats.process);
+  g_assert (stats.total >= stats.resolve);
+
+  delete doc;
+
+  // Stats are reset even if processing fails.
+  stats.elements = 42;
+  stats.total = GINGA_TIME_NONE;
+  doc = Parser::parseBuffer ("<x/>", 4, 100, 100, &msg, &stats);
+  g_assert_null (doc);
+  g_assert_cmpint (stats.elements, ==, 0);
+  g_assert (stats.total != GINGA_TIME_NONE);
+
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,136 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+// Parses buf in both modes and checks that they fail with the same message.
+static void
+check_failure (const string &buf)
+{
+  Document *doc;
+  string msg_dom = "";
+  string msg_stream = "";
+
+  doc = Parser::parseBuffer (buf.c_str (), buf.length (), 100, 100,
+                             &msg_dom);
+  g_assert_null (doc);
+  doc = Parser::parseBufferStreaming (buf.c_str (), buf.length (), 100,
+                                      100, &msg_stream);
+  g_assert_null (doc);
+  if (msg_dom != msg_stream)
+    {
+      g_printerr ("*** Expected:\t\"%s\"\n", msg_dom.c_str ());
+      g_printerr ("*** Got:\t\"%s\"\n", msg_stream.c_str ());
+      g_assert_not_reached ();
+    }
+}
+
+int
+main (void)
+{
+  Document *doc;
+  ParserStats stats;
+  string buf;
+  string msg;
+
+  // XML errors are reported by LibXML.
+  doc = Parser::parseBufferStreaming ("<ncl>", 5, 100, 100, &msg);
+  g_assert_null (doc);
+  g_assert (msg.find ("XML error") != string::npos);
+
+  // Other errors are reported as in the DOM mode.
+  check_failure ("<unknown/>");
+  check_failure ("<ncl><media/></ncl>");
+  check_failure ("<ncl><head><unknown/></head></ncl>");
+  check_failure ("<ncl><body><media id='m' unknown='x'/></body></ncl>");
+  check_failure ("<ncl><body><port id='p' component='x'/></body></ncl>");
+
+  // Forward references are resolved at the end of the document.
+  buf = "\
+<ncl>\n\
+ <head>\n\
+  <regionBase>\n\
+   <region id='r' left='25%'/>\n\
+  </regionBase>\n\
+  <descriptorBase>\n\
+   <descriptor id='d' region='r'/>\n\
+  </descriptorBase>\n\
+  <connectorBase>\n\
+   <causalConnector id='onBeginStart'>\n\
+    <simpleCondition role='onBegin'/>\n\
+    <simpleAction role='start'/>\n\
+   </causalConnector>\n\
+  </connectorBase>\n\
+ </head>\n\
+ <body>\n\
+  <port id='p' component='m1'/>\n\
+  <link xconnector='onBeginStart'>\n\
+   <bind role='onBegin' component='m1'/>\n\
+   <bind role='start' component='c' interface='p2'/>\n\
+  </link>\n\
+  <media id='m1' descriptor='d'>\n\
+   <property name='top' value='50%'/>\n\
+  </media>\n\
+  <context id='c'>\n\
+   <port id='p2' component='m2'/>\n\
+   <media id='m2'/>\n\
+  </context>\n\
+ </body>\n\
+</ncl>\n";
+
+  doc = Parser::parseBufferStreaming (buf.c_str (), buf.length (), 100,
+                                      100, &msg, &stats);
+  if (doc == nullptr)
+    {
+      g_printerr ("*** Unexpected error: %s", msg.c_str ());
+      g_assert_not_reached ();
+    }
+
+  Context *root = doc->getRoot ();
+  g_assert_nonnull (root);
+  g_assert (root->getPorts ()->size () == 1);
+  g_assert (root->getLinks ()->size () == 1);
+
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+  g_assert (doubleeq (xstrtodorpercent (m1->getProperty ("left"), nullptr),
+                      .25));
+  g_assert (doubleeq (xstrtodorpercent (m1->getProperty ("top"), nullptr),
+                      .5));
+
+  Context *c = cast (Context *, doc->getObjectById ("c"));
+  g_assert_nonnull (c);
+  g_assert (c->getPorts ()->size () == 1);
+  g_assert_nonnull (doc->getObjectById ("m2"));
+
+  g_assert_cmpint (stats.elements, >, 0);
+  g_assert_cmpint (stats.cached, <=, stats.elements);
+  g_assert (stats.total >= stats.process);
+
+  // Both modes produce the same objects.
+  Document *dom = Parser::parseBuffer (buf.c_str (), buf.length (), 100,
+                                       100, &msg);
+  g_assert_nonnull (dom);
+  g_assert (dom->getObjects ()->size () == doc->getObjects ()->size ());
+  for (auto obj : *dom->getObjects ())
+    g_assert_nonnull (doc->getObjectById (obj->getId ()));
+
+  delete dom;
+  delete doc;
+
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,103 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+static string
+connector_base (const string &id)
+{
+  return "\
+<ncl>\n\
+ <head>\n\
+  <connectorBase>\n\
+   <causalConnector id='" + id + "'>\n\
+    <simpleCondition role='onBegin'/>\n\
+    <simpleAction role='start'/>\n\
+   </causalConnector>\n\
+  </connectorBase>\n\
+ </head>\n\
+</ncl>\n";
+}
+
+int
+main (void)
+{
+  Document *doc;
+  string base, file, errmsg;
+
+  base = tests_write_tmp_file (connector_base ("c1"));
+
+  // The same base is imported twice, under different aliases.
+  file = tests_write_tmp_file ("\
+<ncl>\n\
+ <head>\n\
+  <connectorBase>\n\
+   <importBase alias='a' documentURI='" + base + "'/>\n\
+   <importBase alias='b' documentURI='" + base + "'/>\n\
+  </connectorBase>\n\
+ </head>\n\
+ <body>\n\
+  <media id='m1'/>\n\
+  <media id='m2'/>\n\
+  <link xconnector='a#c1'>\n\
+   <bind role='onBegin' component='m1'/>\n\
+   <bind role='start' component='m2'/>\n\
+  </link>\n\
+  <link xconnector='b#c1'>\n\
+   <bind role='onBegin' component='m2'/>\n\
+   <bind role='start' component='m1'/>\n\
+  </link>\n\
+ </body>\n\
+</ncl>\n");
+
+  // Parse twice: the second time the base comes from the import cache.
+  for (int i = 0; i < 2; i++)
+    {
+      doc = Parser::parseFile (file, 100, 100, &errmsg);
+      if (doc == nullptr)
+        {
+          g_printerr ("*** Unexpected error: %s", errmsg.c_str ());
+          g_assert_not_reached ();
+        }
+      g_assert (doc->getRoot ()->getLinks ()->size () == 2);
+      delete doc;
+    }
+
+  // Changing the base invalidates the cached copy.
+  g_assert (g_file_set_contents (base.c_str (),
+                                 connector_base ("c22").c_str (), -1,
+                                 nullptr));
+  doc = Parser::parseFile (file, 100, 100, &errmsg);
+  g_assert_null (doc);
+  g_assert (errmsg.find ("a#c1") != string::npos);
+
+  // Documents parsed after the cache is dropped read the base again.
+  g_assert (g_file_set_contents (base.c_str (),
+                                 connector_base ("c1").c_str (), -1,
+                                 nullptr));
+  Parser::clearImportCache ();
+  doc = Parser::parseFile (file, 100, 100, &errmsg);
+  g_assert_nonnull (doc);
+  g_assert (doc->getRoot ()->getLinks ()->size () == 2);
+  delete doc;
+  Parser::clearImportCache ();
+
+  g_remove (file.c_str ());
+  g_remove (base.c_str ());
+
+  exit (EXIT_SUCCESS);
+}
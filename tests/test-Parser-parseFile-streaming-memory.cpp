@@ -0,0 +1,151 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+
+#include "tests.h"
+#include <libxml/parser.h>
+
+// Counts the memory allocated by LibXML.  Each block is prefixed by its
+// size, so that frees can be accounted for.
+#define HEADER (2 * sizeof (size_t))
+
+static size_t mem_current = 0;
+static size_t mem_peak = 0;
+
+static void *
+mem_malloc (size_t size)
+{
+  char *ptr = (char *) malloc (HEADER + size);
+  if (ptr == nullptr)
+    return nullptr;
+  *(size_t *) ptr = size;
+  mem_current += size;
+  if (mem_current > mem_peak)
+    mem_peak = mem_current;
+  return ptr + HEADER;
+}
+
+static void
+mem_free (void *mem)
+{
+  char *ptr;
+  if (mem == nullptr)
+    return;
+  ptr = (char *) mem - HEADER;
+  mem_current -= *(size_t *) ptr;
+  free (ptr);
+}
+
+static void *
+mem_realloc (void *mem, size_t size)
+{
+  char *ptr;
+  if (mem == nullptr)
+    return mem_malloc (size);
+  ptr = (char *) mem - HEADER;
+  mem_current -= *(size_t *) ptr;
+  ptr = (char *) realloc (ptr, HEADER + size);
+  if (ptr == nullptr)
+    return nullptr;
+  *(size_t *) ptr = size;
+  mem_current += size;
+  if (mem_current > mem_peak)
+    mem_peak = mem_current;
+  return ptr + HEADER;
+}
+
+static char *
+mem_strdup (const char *str)
+{
+  size_t n = strlen (str) + 1;
+  char *dup = (char *) mem_malloc (n);
+  if (dup != nullptr)
+    memcpy (dup, str, n);
+  return dup;
+}
+
+// Parses file and returns the peak memory allocated by LibXML meanwhile.
+static size_t
+parse_peak (const string &file, bool streaming, ParserStats *stats)
+{
+  Document *doc;
+  string errmsg;
+
+  mem_peak = mem_current;
+  if (streaming)
+    doc = Parser::parseFileStreaming (file, 100, 100, &errmsg, stats);
+  else
+    doc = Parser::parseFile (file, 100, 100, &errmsg, stats);
+  if (doc == nullptr)
+    g_printerr ("*** Unexpected error: %s\n", errmsg.c_str ());
+  g_assert_nonnull (doc);
+  delete doc;
+  return mem_peak;
+}
+
+int
+main (void)
+{
+  ParserStats stats_dom;
+  ParserStats stats_stream;
+  size_t peak_dom;
+  size_t peak_stream;
+  string buf;
+  string file;
+
+  // Must be set before LibXML is initialized.
+  g_assert (xmlMemSetup (mem_free, mem_malloc, mem_realloc, mem_strdup)
+            == 0);
+  Parser::init ();
+
+  // A large document: mostly properties, which are not cached.
+  buf = "\
+<ncl>\n\
+ <body>\n\
+  <port id='p' component='m0'/>\n";
+  for (int i = 0; i < 2000; i++)
+    {
+      string id = xstrbuild ("m%d", i);
+      buf += "\
+  <media id='" + id + "' src='" + id + ".png' type='image/png'>\n\
+   <property name='left' value='10%'/>\n\
+   <property name='top' value='20%'/>\n\
+   <property name='width' value='30%'/>\n\
+   <property name='height' value='40%'/>\n\
+   <property name='transparency' value='50%'/>\n\
+  </media>\n";
+    }
+  buf += "\
+ </body>\n\
+</ncl>\n";
+  file = tests_write_tmp_file (buf);
+
+  peak_dom = parse_peak (file, false, &stats_dom);
+  peak_stream = parse_peak (file, true, &stats_stream);
+  g_assert_cmpuint (stats_dom.elements, ==, stats_stream.elements);
+  g_assert_cmpuint (stats_dom.cached, ==, stats_stream.cached);
+
+  // The reader frees each subtree once it is consumed, so the streaming
+  // mode keeps only a fraction of the DOM tree.
+  g_printerr ("peak: dom=%" G_GSIZE_FORMAT " streaming=%" G_GSIZE_FORMAT
+              "\n",
+              peak_dom, peak_stream);
+  g_assert_cmpuint (peak_stream, <, peak_dom / 2);
+
+  g_remove (file.c_str ());
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,86 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+#include "Player.h"
+
+int
+main (void)
+{
+  // Known properties.
+  {
+    string defval;
+
+    g_assert (Player::getPlayerProperty ("background", &defval)
+              == Player::PROP_BACKGROUND);
+    g_assert (defval == "");
+    g_assert (Player::getPlayerProperty ("bounds", &defval)
+              == Player::PROP_BOUNDS);
+    g_assert (defval == "0%,0%,100%,100%");
+    g_assert (Player::getPlayerProperty ("fontBgColor", &defval)
+              == Player::PROP_FONT_BG_COLOR);
+    g_assert (Player::getPlayerProperty ("fontColor", &defval)
+              == Player::PROP_FONT_COLOR);
+    g_assert (defval == "black");
+    g_assert (Player::getPlayerProperty ("transparency", &defval)
+              == Player::PROP_TRANSPARENCY);
+    g_assert (defval == "0%");
+    g_assert (Player::getPlayerProperty ("type", &defval)
+              == Player::PROP_TYPE);
+    g_assert (defval == "application/x-ginga-timer");
+    g_assert (Player::getPlayerProperty ("zIndex", nullptr)
+              == Player::PROP_Z_INDEX);
+    g_assert (Player::getPlayerProperty ("zOrder", nullptr)
+              == Player::PROP_Z_ORDER);
+  }
+
+  // Aliases.
+  {
+    string defval;
+
+    g_assert (Player::getPlayerProperty ("backgroundColor", nullptr)
+              == Player::PROP_BACKGROUND);
+    g_assert (Player::getPlayerProperty ("explicitDur", &defval)
+              == Player::PROP_DURATION);
+    g_assert (defval == "indefinite");
+    g_assert (Player::getPlayerProperty ("rate", nullptr)
+              == Player::PROP_SPEED);
+    g_assert (Player::getPlayerProperty ("soundLevel", nullptr)
+              == Player::PROP_VOLUME);
+  }
+
+  // Unknown properties.
+  {
+    string defval = "x";
+
+    g_assert (Player::getPlayerProperty ("", &defval)
+              == Player::PROP_UNKNOWN);
+    g_assert (defval == "");
+    g_assert (Player::getPlayerProperty ("x", nullptr)
+              == Player::PROP_UNKNOWN);
+    g_assert (Player::getPlayerProperty ("transIn", nullptr)
+              == Player::PROP_UNKNOWN);
+    g_assert (Player::getPlayerProperty ("Top", nullptr)
+              == Player::PROP_UNKNOWN);
+    g_assert (Player::getPlayerProperty ("topp", nullptr)
+              == Player::PROP_UNKNOWN);
+    g_assert (Player::getPlayerProperty ("explicitdur", nullptr)
+              == Player::PROP_UNKNOWN);
+  }
+
+  exit (EXIT_SUCCESS);
+}
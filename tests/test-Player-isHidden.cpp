@@ -0,0 +1,94 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  Formatter *fmt;
+  Document *doc;
+  Player *p1, *p2;
+
+  tests_parse_and_start (&fmt, &doc, "\
+<ncl>\n\
+  <body>\n\
+    <port id='p1' component='m1'/>\n\
+    <port id='p2' component='m2'/>\n\
+    <media id='m1'>\n\
+      <property name='left' value='0'/>\n\
+      <property name='top' value='0'/>\n\
+      <property name='width' value='100'/>\n\
+      <property name='height' value='100'/>\n\
+      <property name='zIndex' value='1'/>\n\
+    </media>\n\
+    <media id='m2'>\n\
+      <property name='background' value='blue'/>\n\
+      <property name='left' value='0'/>\n\
+      <property name='top' value='0'/>\n\
+      <property name='width' value='200'/>\n\
+      <property name='height' value='200'/>\n\
+      <property name='zIndex' value='2'/>\n\
+    </media>\n\
+  </body>\n\
+</ncl>\n");
+
+  Media *m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+  Media *m2 = cast (Media *, doc->getObjectById ("m2"));
+  g_assert_nonnull (m2);
+
+  fmt->sendTick (0, 0, 0);
+  g_assert (m1->isOccurring ());
+  g_assert (m2->isOccurring ());
+  p1 = tests_get_player (fmt, 1);
+  p2 = tests_get_player (fmt, 2);
+
+  // m1 is completely covered by the opaque m2.
+  g_assert_true (p2->isOpaque ());
+  g_assert_false (p2->isHidden ());
+  g_assert_true (p1->isHidden ());
+
+  // A translucent m2 does not hide m1.
+  m2->setProperty ("transparency", "128");
+  fmt->sendTick (0, 0, 1);
+  g_assert_false (p2->isOpaque ());
+  g_assert_false (p1->isHidden ());
+
+  // Neither does an opaque m2 that covers m1 only partially.
+  m2->setProperty ("transparency", "0");
+  m1->setProperty ("left", "150");
+  fmt->sendTick (0, 0, 2);
+  g_assert_false (p1->isHidden ());
+
+  // Off-screen players are hidden.
+  m1->setProperty ("left", "900");
+  fmt->sendTick (0, 0, 3);
+  g_assert_true (p1->isHidden ());
+
+  // So are invisible ones.
+  m1->setProperty ("left", "300");
+  fmt->sendTick (0, 0, 4);
+  g_assert_false (p1->isHidden ());
+  m1->setProperty ("visible", "false");
+  fmt->sendTick (0, 0, 5);
+  g_assert_true (p1->isHidden ());
+
+  delete fmt;
+
+  exit (EXIT_SUCCESS);
+}
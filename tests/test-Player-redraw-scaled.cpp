@@ -0,0 +1,75 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options (32, 16);
+  cairo_surface_t *screen;
+  Formatter *fmt;
+  Media *m;
+  string png, file, errmsg;
+
+  // Write a small image: red on the left half, green on the right half.
+  png = tests_write_tmp_png (8, 4, 0xffff0000, 0xff00ff00);
+
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p' component='m'/>\n\
+  <media id='m' src='%s'/>\n\
+ </body>\n\
+</ncl>\n",
+                                           png.c_str ()));
+  fmt = new Formatter (&opts);
+  g_assert_true (fmt->start (file, &errmsg));
+  m = cast (Media *, fmt->getDocument ()->getObjectById ("m"));
+  g_assert_nonnull (m);
+
+  screen = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 32, 16);
+  g_assert_nonnull (screen);
+
+  // The image is scaled up to the whole screen.
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 4, 8), ==, 0xffff0000);
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 28, 8), ==,
+                   0xff00ff00);
+
+  // Shrinking rescales it; nothing is drawn outside the new rect.
+  m->setProperty ("width", "8");
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 2, 8), ==, 0xffff0000);
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 6, 8), ==, 0xff00ff00);
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 12, 8), ==,
+                   0xff000000);
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 28, 8), ==,
+                   0xff000000);
+
+  // Growing it back rescales it again.
+  m->setProperty ("width", "100%");
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 4, 8), ==, 0xffff0000);
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 12, 8), ==,
+                   0xffff0000);
+  g_assert_cmphex (tests_redraw_and_peek (fmt, screen, 28, 8), ==,
+                   0xff00ff00);
+
+  cairo_surface_destroy (screen);
+  delete fmt;
+  g_remove (file.c_str ());
+  g_remove (png.c_str ());
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,79 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+#include "PlayerImage.h"
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options ();
+  PlayerImageCacheStats stats;
+  Formatter *fmt;
+  Document *doc;
+  string png, file, errmsg;
+
+  // Write a small image.
+  png = tests_write_tmp_png (16, 8, 0, 0);
+
+  PlayerImage::clearCache ();
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.entries, ==, 0);
+  g_assert_cmpuint (stats.bytes, ==, 0);
+
+  // Two media objects showing the same image share a single decode.
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p1' component='m1'/>\n\
+  <port id='p2' component='m2'/>\n\
+  <media id='m1' src='%s'/>\n\
+  <media id='m2' src='%s'/>\n\
+ </body>\n\
+</ncl>\n",
+                                           png.c_str (), png.c_str ()));
+  fmt = new Formatter (&opts);
+  g_assert_true (fmt->start (file, &errmsg));
+  doc = fmt->getDocument ();
+  g_assert_nonnull (doc);
+  g_assert (doc->getObjectById ("m1")->isOccurring ());
+  g_assert (doc->getObjectById ("m2")->isOccurring ());
+
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 1);
+  g_assert_cmpuint (stats.hits, ==, 1);
+  g_assert_cmpuint (stats.entries, ==, 1);
+  g_assert_cmpuint (stats.bytes, >=, 16 * 8 * 4);
+
+  // Images in use are never evicted.
+  PlayerImage::setCacheBudget (0);
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.entries, ==, 1);
+  g_assert_cmpuint (stats.evictions, ==, 0);
+
+  // Unused images are evicted once they exceed the budget.
+  g_assert_true (fmt->stop ());
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.entries, ==, 0);
+  g_assert_cmpuint (stats.bytes, ==, 0);
+  g_assert_cmpuint (stats.evictions, ==, 1);
+
+  delete fmt;
+  g_remove (file.c_str ());
+  g_remove (png.c_str ());
+  exit (EXIT_SUCCESS);
+}
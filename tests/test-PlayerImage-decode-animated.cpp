@@ -0,0 +1,90 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+#include "PlayerImage.h"
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options ();
+  PlayerImageCacheStats stats;
+  cairo_surface_t *screen;
+  Formatter *fmt;
+  Document *doc;
+  Media *m;
+  string png, file, errmsg;
+
+  // Write a 64x32 image.
+  png = tests_write_tmp_png (64, 32, 0, 0);
+
+  PlayerImage::clearCache ();
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p' component='m'/>\n\
+  <media id='m' src='%s'>\n\
+   <property name='width' value='0'/>\n\
+   <property name='height' value='0'/>\n\
+  </media>\n\
+ </body>\n\
+</ncl>\n",
+                                           png.c_str ()));
+  fmt = new Formatter (&opts);
+  g_assert_true (fmt->start (file, &errmsg));
+  doc = fmt->getDocument ();
+  g_assert_nonnull (doc);
+  m = cast (Media *, doc->getObjectById ("m"));
+  g_assert_nonnull (m);
+
+  screen = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 800, 600);
+  g_assert_nonnull (screen);
+
+  // Images are not decoded before they have a size.
+  tests_redraw_and_peek (fmt, screen);
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 0);
+
+  m->setProperty ("width", "16");
+  m->setProperty ("height", "8");
+  tests_redraw_and_peek (fmt, screen);
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 1);
+  g_assert_cmpuint (stats.bytes, ==, 16 * 8 * 4);
+
+  // Size animations don't decode the image while running ...
+  m->setProperty ("width", "64", 1 * GINGA_SECOND);
+  m->setProperty ("height", "32", 1 * GINGA_SECOND);
+  tests_redraw_and_peek (fmt, screen);
+  g_assert_true (fmt->sendTick (GINGA_SECOND / 2, GINGA_SECOND / 2, 1));
+  tests_redraw_and_peek (fmt, screen);
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 1);
+
+  // ... but decode it again at the final size once they are over.
+  g_assert_true (fmt->sendTick (2 * GINGA_SECOND, 3 * GINGA_SECOND / 2, 2));
+  tests_redraw_and_peek (fmt, screen);
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 2);
+  g_assert_cmpuint (stats.entries, ==, 2);
+
+  cairo_surface_destroy (screen);
+  delete fmt;
+  g_remove (file.c_str ());
+  g_remove (png.c_str ());
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,91 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+#include "PlayerImage.h"
+
+static gint wakeups = 0;
+
+static void
+count_wakeup (unused (void *data))
+{
+  g_atomic_int_inc (&wakeups);
+}
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options (16, 8);
+  PlayerImageCacheStats stats;
+  cairo_surface_t *screen;
+  Formatter *fmt;
+  string png, file, errmsg;
+  guint32 pixel;
+
+  opts.syncImageDecode = false;
+  Ginga::setWakeupCallback (count_wakeup, nullptr);
+
+  // Write a small red image.
+  png = tests_write_tmp_png (16, 8, 0xffff0000, 0xffff0000);
+
+  PlayerImage::clearCache ();
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p' component='m'/>\n\
+  <media id='m' src='%s'/>\n\
+ </body>\n\
+</ncl>\n",
+                                           png.c_str ()));
+
+  // Start does not wait for the image; it shows up once decoded.
+  fmt = new Formatter (&opts);
+  g_assert_true (fmt->start (file, &errmsg));
+  g_assert (fmt->getDocument ()->getObjectById ("m")->isOccurring ());
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 1);
+
+  // The host need not poll the decoder: it is woken up once the image is
+  // decoded, and the next tick shows the image.
+  for (int i = 0; i < 5000 && g_atomic_int_get (&wakeups) == 0; i++)
+    g_usleep (1000);
+  g_assert_cmpint (g_atomic_int_get (&wakeups), ==, 1);
+
+  screen = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 16, 8);
+  g_assert_nonnull (screen);
+  g_assert_true (fmt->sendTick (0, 0, 0));
+  g_assert_true (fmt->getDamage (nullptr));
+  pixel = tests_redraw_and_peek (fmt, screen);
+  g_assert_cmphex (pixel, ==, 0xffff0000);
+
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.entries, ==, 1);
+  g_assert_cmpuint (stats.bytes, >=, 16 * 8 * 4);
+
+  // Stopping while decoding is safe.
+  g_assert_true (fmt->stop ());
+  PlayerImage::clearCache ();
+  g_assert_true (fmt->start (file, &errmsg));
+  g_assert_true (fmt->stop ());
+
+  Ginga::setWakeupCallback (nullptr, nullptr);
+  cairo_surface_destroy (screen);
+  delete fmt;
+  g_remove (file.c_str ());
+  g_remove (png.c_str ());
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,84 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+#include "PlayerImage.h"
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options ();
+  PlayerImageCacheStats stats;
+  cairo_surface_t *screen;
+  Formatter *fmt;
+  Document *doc;
+  Media *m1;
+  string png, file, errmsg;
+
+  // Write a 64x32 image.
+  png = tests_write_tmp_png (64, 32, 0, 0);
+
+  PlayerImage::clearCache ();
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p1' component='m1'/>\n\
+  <port id='p2' component='m2'/>\n\
+  <media id='m1' src='%s'>\n\
+   <property name='width' value='16'/>\n\
+   <property name='height' value='8'/>\n\
+  </media>\n\
+  <media id='m2' src='%s'/>\n\
+ </body>\n\
+</ncl>\n",
+                                           png.c_str (), png.c_str ()));
+  fmt = new Formatter (&opts);
+  g_assert_true (fmt->start (file, &errmsg));
+  doc = fmt->getDocument ();
+  g_assert_nonnull (doc);
+  m1 = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (m1);
+
+  // m1 is decoded at 16x8; m2 (800x600) is not scaled up.
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 2);
+  g_assert_cmpuint (stats.entries, ==, 2);
+  g_assert_cmpuint (stats.bytes, ==, 16 * 8 * 4 + 64 * 32 * 4);
+
+  screen = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 800, 600);
+  g_assert_nonnull (screen);
+
+  // Small size changes reuse the decoded image.
+  m1->setProperty ("width", "18");
+  tests_redraw_and_peek (fmt, screen);
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 2);
+
+  // Large size changes decode the image again.
+  m1->setProperty ("width", "32");
+  m1->setProperty ("height", "16");
+  tests_redraw_and_peek (fmt, screen);
+  PlayerImage::getCacheStats (&stats);
+  g_assert_cmpuint (stats.misses, ==, 3);
+  g_assert_cmpuint (stats.entries, ==, 3);
+
+  cairo_surface_destroy (screen);
+  delete fmt;
+  g_remove (file.c_str ());
+  g_remove (png.c_str ());
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,105 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options ();
+  Formatter *fmt;
+  Document *doc;
+  Media *m2;
+  Player *p1, *p2, *p3, *p4;
+  string opaque, translucent, file, errmsg;
+
+  // Write an opaque image and one with a transparent half.
+  opaque = tests_write_tmp_png (16, 8, 0xffff0000, 0xff00ff00);
+  translucent = tests_write_tmp_png (16, 8, 0xffff0000, 0);
+
+  // m2 (opaque) covers m1; m4 (translucent) covers m3.
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+ <body>\n\
+  <port id='p1' component='m1'/>\n\
+  <port id='p2' component='m2'/>\n\
+  <port id='p3' component='m3'/>\n\
+  <port id='p4' component='m4'/>\n\
+  <media id='m1'>\n\
+   <property name='background' value='blue'/>\n\
+   <property name='left' value='0'/>\n\
+   <property name='width' value='100'/>\n\
+   <property name='height' value='100'/>\n\
+   <property name='zIndex' value='1'/>\n\
+  </media>\n\
+  <media id='m2' src='%s'>\n\
+   <property name='left' value='0'/>\n\
+   <property name='width' value='100'/>\n\
+   <property name='height' value='100'/>\n\
+   <property name='zIndex' value='2'/>\n\
+  </media>\n\
+  <media id='m3'>\n\
+   <property name='background' value='blue'/>\n\
+   <property name='left' value='200'/>\n\
+   <property name='width' value='100'/>\n\
+   <property name='height' value='100'/>\n\
+   <property name='zIndex' value='3'/>\n\
+  </media>\n\
+  <media id='m4' src='%s'>\n\
+   <property name='left' value='200'/>\n\
+   <property name='width' value='100'/>\n\
+   <property name='height' value='100'/>\n\
+   <property name='zIndex' value='4'/>\n\
+  </media>\n\
+ </body>\n\
+</ncl>\n",
+                                           opaque.c_str (),
+                                           translucent.c_str ()));
+  fmt = new Formatter (&opts);
+  g_assert_true (fmt->start (file, &errmsg));
+  doc = fmt->getDocument ();
+  g_assert_nonnull (doc);
+  m2 = cast (Media *, doc->getObjectById ("m2"));
+  g_assert_nonnull (m2);
+
+  g_assert_true (fmt->sendTick (0, 0, 0));
+  p1 = tests_get_player (fmt, 1);
+  p2 = tests_get_player (fmt, 2);
+  p3 = tests_get_player (fmt, 3);
+  p4 = tests_get_player (fmt, 4);
+
+  // An image without alpha channel hides what is below it, even with no
+  // background.
+  g_assert_true (p2->isOpaque ());
+  g_assert_true (p1->isHidden ());
+
+  // A translucent image doesn't.
+  g_assert_false (p4->isOpaque ());
+  g_assert_false (p3->isHidden ());
+
+  // Neither does an opaque image drawn with transparency.
+  m2->setProperty ("transparency", "50%");
+  g_assert_true (fmt->sendTick (0, 0, 1));
+  g_assert_false (p2->isOpaque ());
+  g_assert_false (p1->isHidden ());
+
+  delete fmt;
+  g_remove (file.c_str ());
+  g_remove (opaque.c_str ());
+  g_remove (translucent.c_str ());
+  exit (EXIT_SUCCESS);
+}
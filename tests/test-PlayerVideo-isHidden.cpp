@@ -0,0 +1,100 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+// Ticks and redraws formatter until the given counter of player gets
+// greater than MIN.
+static void
+wait_counter (Formatter *fmt, cairo_surface_t *screen, Player *player,
+              const string &name, guint64 min)
+{
+  for (int i = 0; i < 10000; i++)
+    {
+      g_assert_true (fmt->sendTick (0, 0, 0));
+      tests_redraw_and_peek (fmt, screen);
+      if (xstrtouint64 (player->getProperty (name), 10) > min)
+        return;
+      g_usleep (1000);
+    }
+  g_assert_not_reached ();
+}
+
+int
+main (void)
+{
+  cairo_surface_t *screen;
+  Formatter *fmt;
+  Document *doc;
+  Media *m2;
+  Player *p1;
+  guint64 n;
+  string video;
+
+  video = ABS_TOP_SRCDIR "/tests-ncl/samples/clock.ogv";
+  tests_parse_and_start (&fmt, &doc, xstrbuild ("\
+<ncl>\n\
+  <body>\n\
+    <port id='p1' component='m1'/>\n\
+    <port id='p2' component='m2'/>\n\
+    <media id='m1' src='%s'>\n\
+      <property name='width' value='100'/>\n\
+      <property name='height' value='100'/>\n\
+      <property name='zIndex' value='1'/>\n\
+    </media>\n\
+    <media id='m2'>\n\
+      <property name='background' value='blue'/>\n\
+      <property name='width' value='100'/>\n\
+      <property name='height' value='100'/>\n\
+      <property name='visible' value='false'/>\n\
+      <property name='zIndex' value='2'/>\n\
+    </media>\n\
+  </body>\n\
+</ncl>\n",
+                                                video.c_str ()));
+  m2 = cast (Media *, doc->getObjectById ("m2"));
+  g_assert_nonnull (m2);
+  screen = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 800, 600);
+  g_assert_nonnull (screen);
+
+  g_assert_true (fmt->sendTick (0, 0, 0));
+  p1 = tests_get_player (fmt, 1);
+
+  // Once a frame is shown, the video is opaque even with no background.
+  g_assert_false (p1->isOpaque ());
+  wait_counter (fmt, screen, p1, "framesPresented", 0);
+  g_assert_true (p1->isOpaque ());
+
+  // While covered, frames are not decoded.
+  m2->setProperty ("visible", "true");
+  g_assert_true (fmt->sendTick (0, 0, 0));
+  g_assert_true (p1->isHidden ());
+  n = xstrtouint64 (p1->getProperty ("framesSkipped"), 10);
+  wait_counter (fmt, screen, p1, "framesSkipped", n);
+
+  // Once uncovered, decoding resumes (from the next keyframe).
+  m2->setProperty ("visible", "false");
+  g_assert_true (fmt->sendTick (0, 0, 0));
+  g_assert_false (p1->isHidden ());
+  n = xstrtouint64 (p1->getProperty ("framesPresented"), 10);
+  wait_counter (fmt, screen, p1, "framesPresented", n);
+
+  cairo_surface_destroy (screen);
+  delete fmt;
+
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,162 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+
+#include "tests.h"
+#include "PlayerVideo.h"
+
+// Returns a new sample with the given presentation time.  The segment
+// starts at zero, so PTS and running time are the same.
+static GstSample *
+make_sample (Time pts)
+{
+  GstSegment segment;
+  GstBuffer *buf;
+  GstSample *sample;
+
+  gst_segment_init (&segment, GST_FORMAT_TIME);
+  buf = gst_buffer_new ();
+  g_assert_nonnull (buf);
+  GST_BUFFER_PTS (buf) = pts;
+  sample = gst_sample_new (buf, nullptr, &segment, nullptr);
+  g_assert_nonnull (sample);
+  gst_buffer_unref (buf);
+  return sample;
+}
+
+// Pops the frame due at NOW (in milliseconds) and returns its PTS (in
+// milliseconds), or -1 if no frame is due.
+static gint64
+pop_at (PlayerVideoQueue *queue, gint64 now)
+{
+  GstSample *sample;
+  gint64 pts;
+
+  sample = queue->pop ((Time) now * GINGA_MSECOND);
+  if (sample == nullptr)
+    return -1;
+  pts = (gint64) (GST_BUFFER_PTS (gst_sample_get_buffer (sample))
+                  / GINGA_MSECOND);
+  gst_sample_unref (sample);
+  return pts;
+}
+
+// Checks the queue counters.
+static void
+check_stats (PlayerVideoQueue *queue, guint64 presented, guint dropped,
+             guint64 late, guint64 repeated)
+{
+  PlayerVideoQueueStats stats;
+
+  queue->getStats (&stats);
+  g_assert_cmpuint (stats.presented, ==, presented);
+  g_assert_cmpuint (stats.dropped, ==, dropped);
+  g_assert_cmpuint (stats.late, ==, late);
+  g_assert_cmpuint (stats.repeated, ==, repeated);
+}
+
+int
+main (void)
+{
+  gst_init (nullptr, nullptr);
+
+  // Empty queue: nothing to present, and nothing to repeat yet.
+  {
+    PlayerVideoQueue queue;
+    g_assert_true (queue.isEmpty ());
+    g_assert_cmpint (pop_at (&queue, 0), ==, -1);
+    check_stats (&queue, 0, 0, 0, 0);
+  }
+
+  // Falling behind: the latest due frame is presented and the older ones
+  // are dropped; a frame presented more than 20ms after its time is late.
+  {
+    PlayerVideoQueue queue;
+    for (int i = 0; i < 4; i++)
+      g_assert_true (queue.push (make_sample (i * 10 * GINGA_MSECOND)));
+    g_assert_cmpint (pop_at (&queue, 35), ==, 30);
+    check_stats (&queue, 1, 3, 0, 0);
+    g_assert_true (queue.isEmpty ());
+
+    g_assert_true (queue.push (make_sample (40 * GINGA_MSECOND)));
+    g_assert_cmpint (pop_at (&queue, 60), ==, 40); // 20ms: on time
+    check_stats (&queue, 2, 3, 0, 0);
+
+    g_assert_true (queue.push (make_sample (50 * GINGA_MSECOND)));
+    g_assert_cmpint (pop_at (&queue, 71), ==, 50); // 21ms: late
+    check_stats (&queue, 3, 3, 1, 0);
+  }
+
+  // Arriving early: frames that are not due stay queued, and the previous
+  // frame is repeated meanwhile.
+  {
+    PlayerVideoQueue queue;
+    g_assert_true (queue.push (make_sample (0)));
+    g_assert_true (queue.push (make_sample (100 * GINGA_MSECOND)));
+    g_assert_cmpint (pop_at (&queue, 0), ==, 0);
+    g_assert_cmpint (pop_at (&queue, 50), ==, -1);
+    g_assert_cmpint (pop_at (&queue, 99), ==, -1);
+    g_assert_false (queue.isEmpty ());
+    check_stats (&queue, 1, 0, 0, 2);
+    g_assert_cmpint (pop_at (&queue, 100), ==, 100);
+    check_stats (&queue, 2, 0, 0, 2);
+  }
+
+  // Stalling: while the decoder delivers nothing, every pop repeats the
+  // frame presented last.
+  {
+    PlayerVideoQueue queue;
+    g_assert_true (queue.push (make_sample (0)));
+    g_assert_cmpint (pop_at (&queue, 0), ==, 0);
+    for (int i = 1; i <= 5; i++)
+      g_assert_cmpint (pop_at (&queue, i * 16), ==, -1);
+    check_stats (&queue, 1, 0, 0, 5);
+
+    // The frame that ends the stall is late.
+    g_assert_true (queue.push (make_sample (16 * GINGA_MSECOND)));
+    g_assert_cmpint (pop_at (&queue, 96), ==, 16);
+    check_stats (&queue, 2, 0, 1, 5);
+  }
+
+  // Full queue: the producer drops frames instead of blocking.
+  {
+    PlayerVideoQueue queue;
+    for (int i = 0; i < PLAYER_VIDEO_QUEUE_SIZE; i++)
+      g_assert_true (queue.push (make_sample (i * GINGA_MSECOND)));
+    g_assert_false (queue.push (make_sample (GINGA_SECOND)));
+    check_stats (&queue, 0, 1, 0, 0);
+    queue.flush ();
+    g_assert_true (queue.isEmpty ());
+    check_stats (&queue, 0, 1, 0, 0);
+  }
+
+  // Without a clock, every queued frame is due.
+  {
+    PlayerVideoQueue queue;
+    GstSample *sample;
+    g_assert_true (queue.push (make_sample (0)));
+    g_assert_true (queue.push (make_sample (GINGA_SECOND)));
+    sample = queue.pop (GINGA_TIME_NONE);
+    g_assert_nonnull (sample);
+    g_assert_cmpuint (GST_BUFFER_PTS (gst_sample_get_buffer (sample)), ==,
+                      GINGA_SECOND);
+    gst_sample_unref (sample);
+    check_stats (&queue, 1, 1, 0, 0);
+  }
+
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,126 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+// Ticks and redraws formatter until the given property of player gets the
+// given value.
+static void
+wait_property (Formatter *fmt, cairo_surface_t *screen, Player *player,
+               const string &name, const string &value)
+{
+  for (int i = 0; i < 10000; i++)
+    {
+      g_assert_true (fmt->sendTick (0, 0, 0));
+      tests_redraw_and_peek (fmt, screen);
+      if (player->getProperty (name) == value)
+        return;
+      g_usleep (1000);
+    }
+  g_assert_not_reached ();
+}
+
+// Starts the clock sample (400x300) in a 100x75 player with the given
+// options and returns its player.
+static Player *
+start_video (Formatter **fmt, GingaOptions *opts, Media **media)
+{
+  Document *doc;
+  string video, file, errmsg;
+
+  video = ABS_TOP_SRCDIR "/tests-ncl/samples/clock.ogv";
+  file = tests_write_tmp_file (xstrbuild ("\
+<ncl>\n\
+  <body>\n\
+    <port id='p1' component='m1'/>\n\
+    <media id='m1' src='%s'>\n\
+      <property name='width' value='100'/>\n\
+      <property name='height' value='75'/>\n\
+      <property name='zIndex' value='1'/>\n\
+    </media>\n\
+  </body>\n\
+</ncl>\n",
+                                           video.c_str ()));
+  *fmt = new Formatter (opts);
+  g_assert_nonnull (*fmt);
+  g_assert_true ((*fmt)->start (file, &errmsg));
+  g_assert (g_remove (file.c_str ()) == 0);
+  doc = (*fmt)->getDocument ();
+  g_assert_nonnull (doc);
+  *media = cast (Media *, doc->getObjectById ("m1"));
+  g_assert_nonnull (*media);
+  g_assert_true ((*fmt)->sendTick (0, 0, 0));
+  return tests_get_player (*fmt, 1);
+}
+
+int
+main (void)
+{
+  GingaOptions opts = tests_default_options ();
+  cairo_surface_t *screen;
+  Formatter *fmt;
+  Media *m1;
+  Player *p1;
+
+  screen = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 800, 600);
+  g_assert_nonnull (screen);
+
+  // By default, frames keep their native size.
+  p1 = start_video (&fmt, &opts, &m1);
+  wait_property (fmt, screen, p1, "frameWidth", "400");
+  g_assert (p1->getProperty ("frameHeight") == "300");
+  g_assert (p1->getProperty ("convertWidth") == "");
+  delete fmt;
+
+  // With scaleVideo, frames are scaled down to the player size ...
+  opts.scaleVideo = true;
+  p1 = start_video (&fmt, &opts, &m1);
+  wait_property (fmt, screen, p1, "frameWidth", "100");
+  g_assert (p1->getProperty ("frameHeight") == "75");
+
+  // ... before they are converted to BGRA, so conversion works on frames
+  // of the player size ...
+  g_assert (p1->getProperty ("convertWidth") == "100");
+  g_assert (p1->getProperty ("convertHeight") == "75");
+  g_assert (p1->getProperty ("convertFormat") != "");
+  g_assert (p1->getProperty ("convertFormat") != "BGRA");
+
+  // ... renegotiated when the player is resized ...
+  m1->setProperty ("width", "200");
+  m1->setProperty ("height", "150");
+  wait_property (fmt, screen, p1, "frameWidth", "200");
+  g_assert (p1->getProperty ("frameHeight") == "150");
+  g_assert (p1->getProperty ("convertWidth") == "200");
+  g_assert (p1->getProperty ("convertHeight") == "150");
+
+  // ... and never scaled up.
+  m1->setProperty ("width", "800");
+  m1->setProperty ("height", "600");
+  wait_property (fmt, screen, p1, "frameWidth", "400");
+  g_assert (p1->getProperty ("frameHeight") == "300");
+
+  // Frame-queue counters: presented frames are counted, and in cairo mode
+  // nothing is uploaded.
+  g_assert_cmpuint (xstrtouint64 (p1->getProperty ("framesPresented"), 10),
+                    >, 0);
+  g_assert (p1->getProperty ("framesUploaded") == "0");
+  g_assert (p1->getProperty ("uploadFormat") == "");
+  delete fmt;
+
+  cairo_surface_destroy (screen);
+  exit (EXIT_SUCCESS);
+}
@@ -0,0 +1,74 @@
+/* Copyright (C) 2006-2018 PUC-Rio/Laboratorio TeleMidia
+
+This file is part of Ginga (Ginga-NCL).
+
+Ginga is free software: you can redistribute it and/or modify it
+under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 2 of the License, or
+(at your option) any later version.
+
+Ginga is distributed in the hope that it will be useful, but WITHOUT
+ANY WARRANTY; without even the implied warranty of MERCHANTABILITY
+or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public
+License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Ginga.  If not, see <https://www.gnu.org/licenses/>.  */
+
+#include "tests.h"
+
+int
+main (void)
+{
+  // Selection is reused until a rule property changes.
+  {
+    Formatter *fmt;
+    Document *doc;
+    MediaSettings *settings;
+    Event *body_lambda, *swt1_lambda, *swt1_sel, *m1_lambda, *m2_lambda;
+
+    tests_create_document_with_switch_and_start (&fmt, &body_lambda,
+                                                 &swt1_lambda, &swt1_sel,
+                                                 &m1_lambda, &m2_lambda);
+    doc = fmt->getDocument ();
+    g_assert_nonnull (doc);
+    settings = doc->getSettings ();
+    g_assert_nonnull (settings);
+
+    // var1 == 'm1', m1 is selected
+    g_assert (swt1_lambda->getState () == Event::OCCURRING);
+    g_assert (m1_lambda->getState () == Event::OCCURRING);
+    g_assert (m2_lambda->getState () == Event::SLEEPING);
+
+    // Restart: m1 is selected again
+    g_assert_true (swt1_lambda->transition (Event::STOP));
+    g_assert_true (swt1_lambda->transition (Event::START));
+    g_assert (m1_lambda->getState () == Event::OCCURRING);
+    g_assert (m2_lambda->getState () == Event::SLEEPING);
+
+    // Setting a property not used by rules: m1 is selected again
+    settings->setProperty ("var2", "m2", 0);
+    g_assert_true (swt1_lambda->transition (Event::STOP));
+    g_assert_true (swt1_lambda->transition (Event::START));
+    g_assert (m1_lambda->getState () == Event::OCCURRING);
+    g_assert (m2_lambda->getState () == Event::SLEEPING);
+
+    // var1 = 'm2': m2 is selected on restart
+    settings->setProperty ("var1", "m2", 0);
+    g_assert_true (swt1_lambda->transition (Event::STOP));
+    g_assert_true (swt1_lambda->transition (Event::START));
+    g_assert (m1_lambda->getState () == Event::SLEEPING);
+    g_assert (m2_lambda->getState () == Event::OCCURRING);
+
+    // var1 = 'm3': nothing is selected
+    settings->setProperty ("var1", "m3", 0);
+    g_assert_true (swt1_lambda->transition (Event::STOP));
+    g_assert_false (swt1_lambda->transition (Event::START));
+    g_assert (m1_lambda->getState () == Event::SLEEPING);
+    g_assert (m2_lambda->getState () == Event::SLEEPING);
+
+    delete fmt;
+  }
+
+  exit (EXIT_SUCCESS);
+}
@@ -82,6 +82,96 @@ tests_write_tmp_file (const string &buf, const string &file_ext = "ncl")
   return path;
 }
 
+// Returns the options of a WIDTH x HEIGHT formatter for tests: images are
+// decoded synchronously, so that they can be checked right after start;
+// all other options have their default values.
+static G_GNUC_UNUSED GingaOptions
+tests_default_options (int width = 800, int height = 600)
+{
+  GingaOptions opts;
+
+  opts.width = width;
+  opts.height = height;
+  opts.debug = false;
+  opts.experimental = false;
+  opts.opengl = false;
+  opts.background = "";
+  opts.imageCacheSize = 32768;
+  opts.syncImageDecode = true;
+  opts.streamingParse = false;
+  opts.backgroundParse = false;
+  opts.scaleVideo = false;
+  return opts;
+}
+
+// Writes a WIDTH x HEIGHT PNG image into a temporary file and returns its
+// path.  The left half of the image is painted with the ARGB color LEFT
+// and the right half with the ARGB color RIGHT.  If both colors are opaque,
+// the image has no alpha channel.
+static G_GNUC_UNUSED string
+tests_write_tmp_png (int width, int height, guint32 left, guint32 right)
+{
+  cairo_surface_t *sfc;
+  cairo_t *cr;
+  string path;
+  bool opaque;
+
+  opaque = (left >> 24) == 0xff && (right >> 24) == 0xff;
+  sfc = cairo_image_surface_create (
+      opaque ? CAIRO_FORMAT_RGB24 : CAIRO_FORMAT_ARGB32, width, height);
+  g_assert_nonnull (sfc);
+  cr = cairo_create (sfc);
+  g_assert_nonnull (cr);
+  cairo_set_operator (cr, CAIRO_OPERATOR_SOURCE);
+  for (int i = 0; i < 2; i++)
+    {
+      guint32 c = (i == 0) ? left : right;
+      cairo_set_source_rgba (cr, ((c >> 16) & 0xff) / 255.,
+                             ((c >> 8) & 0xff) / 255., (c & 0xff) / 255.,
+                             ((c >> 24) & 0xff) / 255.);
+      cairo_rectangle (cr, i * (width / 2.), 0, width / 2., height);
+      cairo_fill (cr);
+    }
+  cairo_destroy (cr);
+
+  path = tests_write_tmp_file ("", "png");
+  g_assert (cairo_surface_write_to_png (sfc, path.c_str ())
+            == CAIRO_STATUS_SUCCESS);
+  cairo_surface_destroy (sfc);
+  return path;
+}
+
+// Redraws formatter onto SCREEN and returns the ARGB value of the pixel at
+// (X,Y).
+static G_GNUC_UNUSED guint32
+tests_redraw_and_peek (Formatter *fmt, cairo_surface_t *screen, int x = 0,
+                       int y = 0)
+{
+  cairo_t *cr = cairo_create (screen);
+  g_assert_nonnull (cr);
+  fmt->redraw (cr);
+  cairo_destroy (cr);
+  cairo_surface_flush (screen);
+  return *(guint32 *) (cairo_image_surface_get_data (screen)
+                       + y * cairo_image_surface_get_stride (screen) + 4 * x);
+}
+
+// Returns the player in the display list of formatter with the given
+// z-index.
+static G_GNUC_UNUSED Player *
+tests_get_player (Formatter *fmt, int zindex)
+{
+  for (auto player : *fmt->getDisplayList ())
+    {
+      int z;
+      player->getZ (&z, nullptr);
+      if (z == zindex)
+        return player;
+    }
+  g_assert_not_reached ();
+  return nullptr;
+}
+
 static G_GNUC_UNUSED void
 tests_parse_and_start (Formatter **fmt, Document **doc, const string &buf,
                        const string &file_ext = "ncl")